@@ -0,0 +1,48 @@
+#ifndef __TS_BATCH_READER_HPP__
+#define __TS_BATCH_READER_HPP__
+
+#include "FileReader.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+namespace TS
+{
+    struct BatchOptions
+    {
+        unsigned job_count{ 0 };  // number of files read at the same time, 0 means one per hardware thread
+    };
+
+    // Reads several TS files concurrently, on a pool of worker threads
+    //
+    // Each file is read by its own FileReader, within its own demux context, so files don't share any demuxing state
+    // Output files are prefixed with the position and the stem of their TS file (e.g. 2_news_), so that the outputs of different files don't overwrite each other
+    // The messages of a file (warnings, stats and errors) are collected, and printed all together once the file is done
+    // An error in a file doesn't stop the others: start() throws CouldNotReadTSFiles at the end if any of them failed
+    //
+    class BatchReader
+    {
+    public:
+        BatchReader(const std::vector<std::filesystem::path>& file_paths, const FileReaderOptions& options,
+            const BatchOptions& batch_options);
+
+        void start();
+
+    private:
+        void run_worker();
+        void read_file(size_t file_index);
+
+        std::vector<std::filesystem::path> _file_paths{};
+        FileReaderOptions _options{};
+        BatchOptions _batch_options{};
+
+        std::atomic<size_t> _next_file_index{ 0 };
+        std::atomic<size_t> _failed_count{ 0 };
+        std::mutex _output_mutex{};
+    };
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef __TS_BIT_FIELD_HPP__
+#define __TS_BIT_FIELD_HPP__
+
+#include "ByteBufferView.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace TS
+{
+    // Bit fields describe, at compile time, where a field lives within a chunk of bytes read from a packet buffer:
+    // - byte offset: position of the first byte containing the field, counted from the start of the chunk,
+    // - bit shift: number of bits at the right of the field, within the last byte containing it, and
+    // - bit width: number of bits of the field.
+    //
+    // E.g. the PID in the TS header is bit_field<uint16_t, 1, 0, 13>:
+    //
+    //    [header chunk]       0          1          2          3      (index)
+    //                    ---------------------------------------------
+    //                    | ssssssss | teptPPPP | PPPPPPPP | ccaacccc |
+    //                    ---------------------------------------------
+    //                                  ^^^^^^^^^^^^^^^^^^  PID: 13 bits starting at byte 1, 0 bits of shift
+    //
+    // Reading a field just loads its bytes as a big endian integer, shifts it and masks it
+    // No allocation takes place, and everything but the bytes themselves is known at compile time
+    //
+    template <typename ValueType, size_t ByteOffset, uint8_t BitShift, uint8_t BitWidth>
+    struct bit_field
+    {
+        static_assert(BitShift < 8, "bit shift must be smaller than a byte");
+        static_assert(BitWidth > 0 and BitShift + BitWidth <= 64, "field must fit in 64 bits");
+        static_assert(BitWidth <= sizeof(ValueType) * 8, "field does not fit in its value type");
+
+        using value_type = ValueType;
+
+        static constexpr size_t byte_offset{ ByteOffset };
+        static constexpr uint8_t bit_shift{ BitShift };
+        static constexpr uint8_t bit_width{ BitWidth };
+        static constexpr size_t byte_count{ (BitShift + BitWidth + 7) / 8 };
+        static constexpr size_t end{ ByteOffset + byte_count };
+        static constexpr uint64_t mask{ BitWidth == 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << BitWidth) - 1 };
+
+        [[nodiscard]] static constexpr uint64_t read_bits(const uint8_t* data) noexcept
+        {
+            uint64_t ret{ 0 };
+            for (size_t i{ 0 }; i < byte_count; ++i)
+            {
+                ret = (ret << 8) | data[byte_offset + i];
+            }
+            return (ret >> bit_shift) & mask;
+        }
+
+        [[nodiscard]] static constexpr value_type read(const uint8_t* data) noexcept
+        {
+            return static_cast<value_type>(read_bits(data));
+        }
+        [[nodiscard]] static constexpr value_type read(const byte_buffer_view& buffer) noexcept
+        {
+            return read(buffer.data());
+        }
+
+        [[nodiscard]] static constexpr bool all_bits_set(const byte_buffer_view& buffer) noexcept
+        {
+            return read_bits(buffer.data()) == mask;
+        }
+        [[nodiscard]] static constexpr bool all_bits_unset(const byte_buffer_view& buffer) noexcept
+        {
+            return read_bits(buffer.data()) == 0;
+        }
+    };
+}
+
+#endif
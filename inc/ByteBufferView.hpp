@@ -11,7 +11,8 @@ namespace TS
     // 
     // At the moment, packets are processed and post-processed before reading the next one,
     // payloads being whether discarded or written out to files as part of that post-processing
-    // That is, payloads or tables spanning across consecutive packets are unimplemented
+    // Tables spanning across consecutive packets are the exception: they are reassembled into pooled section buffers,
+    // and views over those buffers are valid until the next packet is parsed
     // In case we couldn't process a packet before reading the next one (e.g. for correctly dealing with the
     // current/next indicator set to zero), we would need to store the packet data temporarily
     //
@@ -0,0 +1,101 @@
+#ifndef __TS_BYTE_SOURCE_HPP__
+#define __TS_BYTE_SOURCE_HPP__
+
+#include "ByteBufferView.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace TS
+{
+    // Byte sources provide the input of a FileReader as a sliding window over its bytes
+    //
+    // - fill(n) returns a window of n bytes starting at the current position,
+    //   or a shorter one if the input ends before (i.e. a window shorter than requested is the end of the input)
+    // - fill_available(n, min_size) returns a window of up to n bytes as soon as min_size of them are available,
+    //   so that live inputs are demuxed as they come in, a window shorter than min_size being the end of the input
+    //   Inputs other than live ones fill the whole window
+    // - consume(n) moves the current position n bytes forward, n being at most the size of the last window
+    // - get_max_window_size() is the biggest window fill can be asked for
+    //
+    // Windows stay valid until the next call to fill, so packets can be parsed in place, without copying them out
+    //
+    class ByteSource
+    {
+    public:
+        virtual ~ByteSource() = default;
+
+        [[nodiscard]] virtual byte_buffer_view fill(size_t n) = 0;
+        [[nodiscard]] virtual byte_buffer_view fill_available(size_t n, [[maybe_unused]] size_t min_size) { return fill(n); }
+        virtual void consume(size_t n) = 0;
+        [[nodiscard]] virtual size_t get_max_window_size() const { return SIZE_MAX; }
+    };
+
+    // Reads the input from a buffer already in memory (e.g. a range of a memory-mapped file)
+    class MemorySource : public ByteSource
+    {
+    public:
+        explicit MemorySource(const byte_buffer_view& data) : _data{ data } {}
+
+        [[nodiscard]] byte_buffer_view fill(size_t n) override { return _data.subspan(_pos, std::min(n, _data.size() - _pos)); }
+        void consume(size_t n) override { _pos += n; }
+
+        [[nodiscard]] size_t get_position() const { return _pos; }
+
+    private:
+        byte_buffer_view _data{};
+        size_t _pos{ 0 };
+    };
+
+    // Size of the blocks a StreamSource reads the input in
+    constexpr size_t stream_block_size{ 4 * 1024 * 1024 };
+
+    // Reads the input through a std::ifstream into an internal buffer
+    // The input is read in whole blocks, so that file offsets stay block aligned and reads are few and large
+    // (e.g. for pipes or network file systems), and the bytes of a window straddling two blocks are carried over
+    class StreamSource : public ByteSource
+    {
+    public:
+        explicit StreamSource(const std::filesystem::path& file_path, size_t block_size = stream_block_size);
+
+        [[nodiscard]] byte_buffer_view fill(size_t n) override;
+        void consume(size_t n) override { _pos += n; }
+
+    private:
+        std::ifstream _ifs{};
+        size_t _block_size{ stream_block_size };
+        std::vector<uint8_t> _buffer{};
+        size_t _pos{ 0 };  // start of the window within the buffer
+        size_t _end{ 0 };  // end of the bytes read into the buffer
+    };
+
+    enum class InputMode
+    {
+        stream,  // std::ifstream reads
+        mmap,  // memory-mapped file
+        io_uring  // io_uring reads, falling back to stream if io_uring is not available
+    };
+
+    // Inputs other than files: standard input ("-"), and UDP sockets ("udp://[<address>]:<port>", or "rtp://" alike)
+    [[nodiscard]] inline bool is_stdin_input(const std::filesystem::path& input) { return input == "-"; }
+    [[nodiscard]] inline bool is_udp_input(const std::filesystem::path& input)
+    {
+        const std::string url{ input.string() };
+        return url.starts_with("udp://") or url.starts_with("rtp://");
+    }
+
+    // Standard input and named pipes are read with a PipeSource, and UDP sockets with a UdpSource, whatever the input mode
+    // UDP inputs end after idle_timeout_ms without datagrams (0 waits forever)
+    // Warnings, e.g. falling back to blocking reads if io_uring is not available, are written to out
+    [[nodiscard]] std::unique_ptr<ByteSource> make_byte_source(const std::filesystem::path& file_path, InputMode input_mode,
+        std::ostream& out, uint64_t idle_timeout_ms = 0);
+}
+
+#endif
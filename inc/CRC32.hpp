@@ -0,0 +1,36 @@
+#ifndef __TS_CRC32_HPP__
+#define __TS_CRC32_HPP__
+
+#include "ByteBufferView.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace TS
+{
+    // CRC32/MPEG-2, used by PSI and SI sections:
+    // polynomial 0x04C11DB7, initial value 0xFFFFFFFF, input and output not reflected, no final xor
+    //
+    // Two engines are available:
+    // - slicing-by-8: table driven, 8 bytes per iteration, and
+    // - PCLMUL: carry-less multiplication folding, 64 bytes per iteration.
+    // crc32_mpeg2 chooses the PCLMUL engine at runtime if the CPU supports it
+    //
+    constexpr uint32_t crc32_mpeg2_polynomial{ 0x04C1'1DB7 };
+    constexpr uint32_t crc32_mpeg2_initial_value{ 0xFFFF'FFFF };
+
+    [[nodiscard]] uint32_t crc32_mpeg2(const uint8_t* data, size_t size, uint32_t crc = crc32_mpeg2_initial_value);
+    [[nodiscard]] inline uint32_t crc32_mpeg2(const byte_buffer_view& data)
+    {
+        return crc32_mpeg2(data.data(), data.size());
+    }
+
+    [[nodiscard]] uint32_t crc32_mpeg2_slicing_by_8(const uint8_t* data, size_t size, uint32_t crc = crc32_mpeg2_initial_value);
+    // Falls back to slicing-by-8 if the CPU doesn't support PCLMUL
+    [[nodiscard]] uint32_t crc32_mpeg2_PCLMUL(const uint8_t* data, size_t size, uint32_t crc = crc32_mpeg2_initial_value);
+
+    // Byte-by-byte boost implementation, kept as the reference the other engines are checked against (see ts_reader_test)
+    [[nodiscard]] uint32_t crc32_mpeg2_reference(const uint8_t* data, size_t size);
+}
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef __TS_CONTINUITY_COUNTER_HPP__
+#define __TS_CONTINUITY_COUNTER_HPP__
+
+#include <cstdint>
+
+namespace TS
+{
+    // Continuity counter of a PID, checked as ISO/IEC 13818-1 says:
+    // the counter goes up by one with every packet carrying a payload, and stays the same otherwise
+    // A packet can be sent twice (one duplicate), and a discontinuity indicator allows any value
+    // The first packet of a PID sets the counter without being checked
+    //
+    class ContinuityCounter
+    {
+    public:
+        // Returns false on a continuity counter error
+        bool check(uint8_t cc, bool has_payload, bool discontinuity_indicator)
+        {
+            bool valid{ true };
+            bool duplicate{ false };
+            if (_known and not discontinuity_indicator)
+            {
+                if (not has_payload)
+                {
+                    valid = (cc == _last);
+                }
+                else if (cc == _last)
+                {
+                    duplicate = true;
+                    valid = not _last_was_duplicate;
+                }
+                else
+                {
+                    valid = (cc == ((_last + 1) & 0xf));
+                }
+            }
+            _last = cc;
+            _known = true;
+            _last_was_duplicate = duplicate;
+            return valid;
+        }
+
+        [[nodiscard]] bool is_known() const { return _known; }
+        [[nodiscard]] uint8_t get_last() const { return _last; }
+
+    private:
+        uint8_t _last{ 0 };
+        bool _known{ false };
+        bool _last_was_duplicate{ false };
+    };
+}
+
+#endif
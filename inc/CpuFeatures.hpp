@@ -0,0 +1,40 @@
+#ifndef __TS_CPU_FEATURES_HPP__
+#define __TS_CPU_FEATURES_HPP__
+
+// x86 SIMD kernels are compiled for their instruction set via TS_TARGET,
+// and only called after checking, at runtime, that the CPU supports it
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define TS_X86 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define TS_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define TS_TARGET(isa)
+#endif
+
+namespace TS
+{
+    class CpuFeatures
+    {
+    public:
+        CpuFeatures(const CpuFeatures&) = delete;
+        CpuFeatures(CpuFeatures&&) = delete;
+        CpuFeatures& operator=(const CpuFeatures&) = delete;
+        CpuFeatures& operator=(CpuFeatures&&) = delete;
+
+        static const CpuFeatures& get_instance();
+
+        [[nodiscard]] bool has_SSE4_1() const { return _SSE4_1; }
+        [[nodiscard]] bool has_AVX2() const { return _AVX2; }
+        [[nodiscard]] bool has_PCLMUL() const { return _PCLMUL; }
+    private:
+        CpuFeatures();
+
+        bool _SSE4_1{ false };
+        bool _AVX2{ false };
+        bool _PCLMUL{ false };
+    };
+}
+
+#endif
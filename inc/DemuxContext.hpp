@@ -0,0 +1,38 @@
+#ifndef __TS_DEMUX_CONTEXT_HPP__
+#define __TS_DEMUX_CONTEXT_HPP__
+
+#include "Packet.hpp"
+#include "ParseResult.hpp"
+#include "PES_Data.hpp"
+#include "PSI_Tables.hpp"
+#include "Stats.hpp"
+
+#include <iostream>
+#include <ostream>
+
+namespace TS
+{
+    // State of the demuxing of a TS stream: PSI tables, NIT PID, PES data, stats and parse error counts
+    //
+    // Each stream has its own context, so that several streams can be demuxed at the same time (e.g. on different threads)
+    // The context is passed down to the objects reading or updating that state (file reader, demuxer, parser and processor),
+    // and has to outlive them
+    // Warnings and stats are printed to the context output stream
+    //
+    struct DemuxContext
+    {
+        explicit DemuxContext(std::ostream& os = std::cout) : out{ os } {}
+
+        DemuxContext(const DemuxContext&) = delete;
+        DemuxContext& operator=(const DemuxContext&) = delete;
+
+        PSI_Tables PSI_tables{};
+        NIT_PID NIT_pid{};
+        PES_Data PES_data{};
+        Stats stats{ PSI_tables };
+        ParseErrorCounts parse_errors{};
+        std::ostream& out;
+    };
+}
+
+#endif
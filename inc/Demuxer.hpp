@@ -0,0 +1,96 @@
+#ifndef __TS_DEMUXER_HPP__
+#define __TS_DEMUXER_HPP__
+
+#include "DemuxContext.hpp"
+#include "Monitor.hpp"
+#include "FileWriter.hpp"
+#include "PacketBuffer.hpp"
+#include "PacketParser.hpp"
+#include "PacketProcessor.hpp"
+#include "PacketView.hpp"
+#include "ParseResult.hpp"
+#include "PES_Data.hpp"
+#include "PID_Filter.hpp"
+#include "SectionCache.hpp"
+#include "WriterTable.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TS
+{
+    // Elementary stream data a packet has completed, and the writer it has to be written out with
+    struct DemuxOutput
+    {
+        FileWriter* writer{ nullptr };  // nothing to write if null
+        const ES_gather_list* ES_data{ nullptr };
+        // Error the reader has to act on: a loss of sync, or, with the abort policy, any other error
+        ParseResult result{};
+    };
+
+    // Demuxers take the packets of a TS file, one at a time, and, working on the state of its demux context:
+    // - drop them straight away if their PID is not in the PID filter (unless stats are being collected, or the stream monitored),
+    // - decode PES packets from a packet view, and feed them to the packet processor,
+    // - skip PSI sections repeating the last one accepted on their PID,
+    // - fully parse and process other (PSI) packets, updating the PID filter and the writer table,
+    // - collect stats, and
+    // - feed the monitor, if any, which gets the errors of a packet reported
+    //
+    // Errors are returned by the parser and the processor, instead of thrown, and handled as the error policy says,
+    // counting them in the demux context (see ErrorPolicy)
+    // With a monitor, they are reported to it, and the reading goes on, whatever the policy
+    //
+    // Writing the elementary stream data out is left to the caller, so that it can be done somewhere else (e.g. another thread)
+    //
+    template <typename Layout>
+    class BasicDemuxer
+    {
+    public:
+        BasicDemuxer(DemuxContext& context, const std::vector<uint8_t>& stream_type_list, WriterTable& writers, bool collect_stats,
+            Monitor* monitor = nullptr, ErrorPolicy error_policy = ErrorPolicy::abort);
+
+        // The output result is Invalid_sync_byte if the packet doesn't start with a sync byte,
+        // and, with the abort policy, the error of any other packet that couldn't be demuxed (see get_error_message)
+        [[nodiscard]] DemuxOutput demux(BasicPacketBuffer<Layout>& buffer);
+
+        // Drops a packet just by looking at its PID (already decoded, and with a valid sync byte)
+        // Returns false if the packet has to be demuxed
+        [[nodiscard]] bool drop(uint16_t pid)
+        {
+            if (_collect_stats or _monitor or _filter.contains(pid))
+            {
+                return false;
+            }
+            _parser.skip();
+            return true;
+        }
+
+        [[nodiscard]] size_t get_packet_index() const { return _parser.get_packet_index(); }
+
+        // Error that aborted the demuxing: the error, the packet index and the packet
+        [[nodiscard]] const std::string& get_error_message() const { return _error_message; }
+
+    private:
+        // Demuxes a packet, returning the first error found in it
+        ParseResult demux_packet(BasicPacketBuffer<Layout>& buffer, const PacketView& view, size_t packet_index, DemuxOutput& output);
+        // Handles the error of a packet as the error policy says
+        [[nodiscard]] DemuxOutput handle_error(ParseError error, std::string_view message, const PacketView& view, size_t packet_index);
+
+        DemuxContext& _context;
+        BasicPacketParser<Layout> _parser;
+        PacketProcessor _processor;
+        PID_Filter _filter;
+        SectionCache _section_cache{};
+        WriterTable& _writers;
+        bool _collect_stats{ false };
+        Monitor* _monitor{ nullptr };
+        ErrorPolicy _error_policy{ ErrorPolicy::abort };
+        bool _parsed{ false };  // the packet being demuxed has been fully parsed
+        std::string _error_message{};
+    };
+}
+
+#endif
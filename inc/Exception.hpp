@@ -31,6 +31,77 @@ namespace TS
         std::string _message{ "couldn't open TS file: " };
     };
 
+    class CouldNotReadTSFile : public std::exception
+    {
+    public:
+        explicit CouldNotReadTSFile(const std::filesystem::path& fp) { _message += fp.string(); }
+        virtual const char* what() const noexcept override { return _message.c_str(); }
+    private:
+        std::string _message{ "couldn't read TS file: " };
+    };
+
+    class CouldNotReadTSFiles : public std::exception
+    {
+    public:
+        CouldNotReadTSFiles(size_t failed_count, size_t file_count)
+        {
+            _message = "couldn't read " + std::to_string(failed_count) + " of " + std::to_string(file_count) + " TS files";
+        }
+        virtual const char* what() const noexcept override { return _message.c_str(); }
+    private:
+        std::string _message{};
+    };
+
+    struct IoUringUnavailable : public std::runtime_error
+    {
+        explicit IoUringUnavailable() : std::runtime_error{ "io_uring is not available" } {}
+    };
+
+    class InvalidUdpAddress : public std::exception
+    {
+    public:
+        explicit InvalidUdpAddress(const std::string& url) { _message += url; }
+        virtual const char* what() const noexcept override { return _message.c_str(); }
+    private:
+        std::string _message{ "invalid UDP address (udp://[<IPv4 address>]:<port>): " };
+    };
+
+    class CouldNotOpenUdpSocket : public std::exception
+    {
+    public:
+        CouldNotOpenUdpSocket(const std::string& url, const std::string& reason) { _message += url + " (" + reason + ")"; }
+        virtual const char* what() const noexcept override { return _message.c_str(); }
+    private:
+        std::string _message{ "couldn't open UDP socket: " };
+    };
+
+    struct UdpInputUnavailable : public std::runtime_error
+    {
+        explicit UdpInputUnavailable() : std::runtime_error{ "UDP input is not supported on this platform" } {}
+    };
+
+
+
+    // Output files
+
+    class CouldNotOpenOutputFile : public std::exception
+    {
+    public:
+        explicit CouldNotOpenOutputFile(const std::filesystem::path& fp) { _message += fp.string(); }
+        virtual const char* what() const noexcept override { return _message.c_str(); }
+    private:
+        std::string _message{ "couldn't open output file: " };
+    };
+
+    class CouldNotWriteOutputFile : public std::exception
+    {
+    public:
+        explicit CouldNotWriteOutputFile(const std::filesystem::path& fp) { _message += fp.string(); }
+        virtual const char* what() const noexcept override { return _message.c_str(); }
+    private:
+        std::string _message{ "couldn't write output file: " };
+    };
+
 
 
     // Command line parser
@@ -54,6 +125,18 @@ namespace TS
     {
         explicit UnrecognizedOption(const char* message) : CommandLineParserException{ message } {}
     };
+    struct ConflictingOptions : public CommandLineParserException
+    {
+        explicit ConflictingOptions(const char* message) : CommandLineParserException{ message } {}
+    };
+    struct DuplicatedTSFilePath : public CommandLineParserException
+    {
+        explicit DuplicatedTSFilePath(const std::filesystem::path& fp)
+            : CommandLineParserException{ "" }, _message{ "duplicated TS file path: " + fp.string() } {}
+        virtual const char* what() const noexcept override { return _message.c_str(); }
+    private:
+        std::string _message{};
+    };
 
 
 
@@ -76,12 +159,39 @@ namespace TS
 
 
 
+    // Section reader
+
+    class SectionReaderOverrun : public std::exception
+    {
+    public:
+        SectionReaderOverrun(size_t bytes_requested_to_read, size_t bytes_left_to_read)
+        {
+            std::ostringstream oss;
+            oss << "trying to read " << bytes_requested_to_read << " bytes from section, "
+                << "but there are only " << bytes_left_to_read << " bytes left to read";
+            _message = oss.str();
+        }
+        virtual const char* what() const noexcept override { return _message.c_str(); }
+    private:
+        std::string _message{};
+    };
+
+
+
     // Packet parser
 
     struct PacketParserException : public std::runtime_error
     {
         explicit PacketParserException(const char* message) : std::runtime_error{ message } {}
     };
+    struct InvalidAdaptationFieldLength : public PacketParserException
+    {
+        InvalidAdaptationFieldLength() : PacketParserException{ "invalid adaptation field length" } {};
+    };
+    struct InvalidPointerField : public PacketParserException
+    {
+        InvalidPointerField() : PacketParserException{ "invalid pointer field" } {};
+    };
     struct InvalidPrivateBit : public PacketParserException
     {
         InvalidPrivateBit() : PacketParserException{ "invalid private bit" } {};
@@ -94,6 +204,10 @@ namespace TS
     {
         InvalidSectionLength() : PacketParserException{ "invalid section length" } {};
     };
+    struct DroppedSection : public PacketParserException
+    {
+        DroppedSection() : PacketParserException{ "dropped PSI section" } {};
+    };
     struct InvalidSectionSyntaxIndicator : public PacketParserException
     {
         InvalidSectionSyntaxIndicator() : PacketParserException{ "invalid section syntax indicator" } {};
@@ -1,30 +1,58 @@
 #ifndef __TS_FILE_READER_HPP__
 #define __TS_FILE_READER_HPP__
 
-#include "Stats.hpp"
+#include "ByteSource.hpp"
+#include "DemuxContext.hpp"
+#include "FileWriter.hpp"
+#include "Monitor.hpp"
+#include "ParallelReader.hpp"
+#include "Pipeline.hpp"
+#include "WriterTable.hpp"
 
 #include <exception>
 #include <filesystem>
-#include <fstream>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace TS
 {
+    // Number of packets read and processed at a time
+    constexpr size_t block_packet_count{ 4096 };
+
+    struct FileReaderOptions
+    {
+        std::vector<uint8_t> stream_type_list{};  // stream types to extract
+        bool collect_stats{ false };
+        InputMode input_mode{ InputMode::stream };
+        uint64_t idle_timeout_ms{ 0 };  // UDP inputs end after this long without datagrams (0 waits forever)
+        FileWriterOptions writer_options{};
+        std::optional<PipelineOptions> pipeline_options{};  // read packets with a pipeline of threads, if set
+        std::optional<ParallelOptions> parallel_options{};  // read chunks of the file with parallel workers, if set
+        std::optional<MonitorOptions> monitor_options{};  // check TR 101 290 indicators, if set
+        ErrorPolicy error_policy{ ErrorPolicy::abort };  // what to do with packets that can't be demuxed
+    };
+
+    // Reads a TS file, demuxing it within the given demux context
     class FileReader
     {
     public:
-        explicit FileReader(
-            const std::filesystem::path& path,
-            std::vector<uint8_t>&& stream_type_list,
-            bool collect_stats);
-        ~FileReader();
+        FileReader(DemuxContext& context, const std::filesystem::path& path, const FileReaderOptions& options);
         void start();
     private:
-        std::ifstream _ifs{};
-        std::vector<uint8_t> _stream_type_list{};
-        bool _collect_stats{false};
+        // Probes the start of the TS file for the packet stride (188, 192 or 204 bytes), without consuming it
+        uint8_t detect_packet_stride();
+
+        template <typename Layout>
+        void read_packets(WriterTable& writers);
+
+        DemuxContext& _context;
+        std::filesystem::path _file_path{};
+        std::unique_ptr<ByteSource> _source{};
+        FileReaderOptions _options{};
+        std::optional<Monitor> _monitor{};
+        size_t _skipped_bytes{ 0 };
     };
 }
 
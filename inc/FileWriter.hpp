@@ -2,24 +2,106 @@
 #define __TS_FILE_WRITER_HPP__
 
 #include "ByteBufferView.hpp"
+#include "SPSC_Ring.hpp"
 #include "StreamType.hpp"
 #include "PES_Data.hpp"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
 #include <fstream>
+#endif
 
 namespace TS
 {
+    // Output buffers, and direct I/O writes, are aligned to the file system block size
+    constexpr size_t write_alignment{ 4096 };
+    constexpr size_t default_write_buffer_size{ 4 * 1024 * 1024 };
+    // Number of buffers of an asynchronous writer: one being filled, the others queued or being written out
+    constexpr size_t async_write_buffer_count{ 4 };
+
+    struct FileWriterOptions
+    {
+        size_t buffer_size{ default_write_buffer_size };  // rounded up to the write alignment
+        bool direct_io{ false };  // bypass the page cache (O_DIRECT), if the file system supports it
+        std::optional<size_t> expected_size{};  // preallocates the output file (fallocate), if known
+        bool async{ false };  // write the buffers out from a background thread
+        std::string file_name_prefix{};  // prepended to the names of the output files
+    };
+
+    // File writers copy the elementary stream data into a large aligned buffer, and write it out when it fills up
+    //
+    // Gather lists that don't fit in the buffer are written along with it in a single writev,
+    // instead of being copied (not with direct I/O though, which needs aligned writes)
+    // Write errors throw CouldNotWriteOutputFile
+    // close() flushes the buffer, and should be called so that errors on the last writes are reported:
+    // the destructor flushes it too, but swallows errors
+    //
+    // Asynchronous writers own a background thread that writes the buffers out, so the parser never waits for the disk
+    // Full buffers are handed over to the thread through a lock-free SPSC ring, and given back through another one
+    // When all the buffers are waiting to be written out, the parser waits for one (back-pressure)
+    // Errors in the thread are thrown by the next flush, or by close(), which also drains the ring and joins the thread
+    //
     class FileWriter
     {
     public:
-        explicit FileWriter(stream_type st) noexcept;
+        FileWriter(stream_type st, const std::filesystem::path& file_path, const FileWriterOptions& options = {});
         ~FileWriter();
 
+        FileWriter(const FileWriter&) = delete;
+        FileWriter& operator=(const FileWriter&) = delete;
+
         stream_type get_stream_type() const;
+        const std::filesystem::path& get_file_path() const { return _file_path; }
         void write(const byte_buffer_view& data);
+        void write(std::span<const byte_buffer_view> data);
+        void close();
     private:
+        struct AlignedDelete { void operator()(uint8_t* p) const; };
+        struct Chunk
+        {
+            uint8_t* data{ nullptr };  // a chunk without data stops the writer thread
+            size_t size{ 0 };
+        };
+
+        // Writes the buffer out, followed by the pending spans (or hands it over to the writer thread)
+        void flush(std::span<const byte_buffer_view> pending = {});
+        void write_chunk(const Chunk& chunk, std::span<const byte_buffer_view> pending = {});
+        void write_spans(const ES_gather_list& spans);
+        void run_writer_thread();
+        void close_file();
+
         stream_type _stream_type{};
+        std::filesystem::path _file_path{};
+        std::vector<std::unique_ptr<uint8_t[], AlignedDelete>> _buffers{};
+        uint8_t* _buffer{ nullptr };  // buffer being filled
+        size_t _buffer_size{ 0 };
+        size_t _used{ 0 };
+        bool _direct_io{ false };  // the file was opened for direct I/O, so buffers are only written out whole
+        bool _file_direct_io{ false };  // the file is still open for direct I/O (only touched by the thread writing it)
+        bool _closed{ false };
+
+        bool _async{ false };
+        SPSC_Ring<Chunk, 2 * async_write_buffer_count> _full_chunks{};
+        SPSC_Ring<uint8_t*, 2 * async_write_buffer_count> _free_buffers{};
+        std::thread _writer_thread{};
+        std::exception_ptr _writer_error{};
+        std::atomic<bool> _writer_failed{ false };
+#if defined(_WIN32)
         std::ofstream _ofs{};
+#else
+        int _fd{ -1 };
+#endif
     };
 }
 
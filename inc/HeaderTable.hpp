@@ -0,0 +1,59 @@
+#ifndef __TS_HEADER_TABLE_HPP__
+#define __TS_HEADER_TABLE_HPP__
+
+#include "ByteBufferView.hpp"
+#include "Packet.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TS
+{
+    // Structure-of-arrays table of TS headers
+    //
+    // Decoding a block of packets into parallel arrays lets us route packets by PID, or check continuity counters,
+    // at header level, without filling a Packet struct for each of them
+    // Entry i of every array corresponds to the packet i of the decoded block
+    //
+    struct HeaderTable
+    {
+        std::vector<uint8_t> sync_byte{};
+        std::vector<uint8_t> transport_error_indicator{};
+        std::vector<uint8_t> payload_unit_start_indicator{};
+        std::vector<uint16_t> PID{};
+        std::vector<uint8_t> transport_scrambling_control{};
+        std::vector<uint8_t> adaptation_field_control{};
+        std::vector<uint8_t> continuity_counter{};
+
+        [[nodiscard]] size_t size() const { return _size; }
+
+        // Resizing only reallocates when the table grows, so a table can be reused across blocks
+        void resize(size_t n);
+
+        [[nodiscard]] bool is_valid(size_t i) const;
+        [[nodiscard]] bool has_adaptation_field(size_t i) const;
+        [[nodiscard]] bool has_payload_data(size_t i) const;
+
+    private:
+        size_t _size{ 0 };
+    };
+
+    // Decodes the headers of the packets contained in a block of contiguous stored packets
+    // Stored packets are stride bytes long, and their TS packet starts after a prefix (see PacketLayout.hpp)
+    // Only whole packets are decoded
+    //
+    // Uses AVX2 (8 packets at a time) or SSE4.1 (4 packets at a time) kernels if the CPU supports them,
+    // and a scalar loop otherwise
+    //
+    void decode_headers(const byte_buffer_view& packets, HeaderTable& table,
+        size_t stride = packet_size, size_t prefix_size = 0);
+
+    // Kernels decode_headers chooses from, each decoding the packets left over by its vector loop with the scalar one
+    // The SIMD kernels fall back to the scalar one if the CPU doesn't support their instruction set (see ts_reader_test)
+    void decode_headers_scalar(const byte_buffer_view& packets, HeaderTable& table, size_t stride, size_t prefix_size);
+    void decode_headers_SSE4_1(const byte_buffer_view& packets, HeaderTable& table, size_t stride, size_t prefix_size);
+    void decode_headers_AVX2(const byte_buffer_view& packets, HeaderTable& table, size_t stride, size_t prefix_size);
+}
+
+#endif
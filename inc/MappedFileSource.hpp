@@ -0,0 +1,52 @@
+#ifndef __TS_MAPPED_FILE_SOURCE_HPP__
+#define __TS_MAPPED_FILE_SOURCE_HPP__
+
+#include "ByteSource.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace TS
+{
+    // Size of the chunks the mapping is prefetched and released in
+    constexpr size_t mapped_chunk_size{ 16 * 1024 * 1024 };
+
+    // Maps the whole file into memory, so that windows are just views into the mapping:
+    // no read system calls, and no copies
+    //
+    // The mapping is read-only, which is fine because packets are never written to
+    // On POSIX systems, the kernel is told the mapping is read sequentially (madvise SEQUENTIAL),
+    // the chunk ahead of the current position is prefetched (WILLNEED),
+    // and chunks already consumed are released (DONTNEED), so that the resident set doesn't grow with the file size
+    //
+    class MappedFileSource : public ByteSource
+    {
+    public:
+        explicit MappedFileSource(const std::filesystem::path& file_path);
+        ~MappedFileSource() override;
+
+        MappedFileSource(const MappedFileSource&) = delete;
+        MappedFileSource& operator=(const MappedFileSource&) = delete;
+
+        [[nodiscard]] byte_buffer_view fill(size_t n) override;
+        void consume(size_t n) override;
+
+    private:
+        void advise(size_t pos);
+
+        uint8_t* _data{ nullptr };
+        size_t _size{ 0 };
+        size_t _pos{ 0 };
+        size_t _released_pos{ 0 };  // start of the chunk not released yet
+        size_t _prefetched_pos{ 0 };  // end of the chunks prefetched so far
+#if defined(_WIN32)
+        void* _file{ nullptr };
+        void* _mapping{ nullptr };
+#else
+        int _fd{ -1 };
+#endif
+    };
+}
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef __TS_MONITOR_HPP__
+#define __TS_MONITOR_HPP__
+
+#include "ContinuityCounter.hpp"
+#include "DemuxContext.hpp"
+#include "Packet.hpp"
+#include "PacketView.hpp"
+#include "ParseResult.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace TS
+{
+    // ETSI TR 101 290 indicators checked by the monitor
+    enum class MonitorCheck : uint8_t
+    {
+        // Priority 1
+        TS_sync_loss,
+        Sync_byte_error,
+        PAT_error,
+        Continuity_count_error,
+        PMT_error,
+        PID_error,
+        // Priority 2
+        Transport_error,
+        CRC_error,
+        PCR_repetition_error,
+        PCR_discontinuity_indicator_error,
+        PTS_error,
+        // Not a TR 101 290 indicator: any other error found while parsing or processing a packet
+        Packet_error
+    };
+    constexpr size_t monitor_check_count{ static_cast<size_t>(MonitorCheck::Packet_error) + 1 };
+
+    // TR 101 290 timing limits, in milliseconds
+    constexpr uint64_t max_PAT_interval_ms{ 500 };
+    constexpr uint64_t max_PMT_interval_ms{ 500 };
+    constexpr uint64_t max_PCR_repetition_ms{ 40 };
+    constexpr uint64_t max_PCR_discontinuity_ms{ 100 };
+    constexpr uint64_t max_PTS_interval_ms{ 700 };
+    // Stream time between two checks of the timeouts (PAT, PMT, PID and PTS)
+    constexpr uint64_t monitor_sweep_interval_ms{ 10 };
+
+    struct MonitorOptions
+    {
+        uint64_t PID_timeout_ms{ 5000 };  // PID_error: elementary stream PIDs not occurring for this long
+    };
+
+    struct MonitorEvent
+    {
+        MonitorCheck check{ MonitorCheck::Packet_error };
+        size_t packet_index{ 0 };
+        std::optional<double> time{};  // seconds since the start of the stream, once the packet rate is known
+        std::optional<PID> pid{};
+        std::string details{};
+
+        friend std::ostream& operator<<(std::ostream& os, const MonitorEvent& event);
+    };
+
+    // TR 101 290 priority 1 and 2 monitor
+    //
+    // The demuxer feeds it every packet, and the errors it would otherwise throw for them
+    // Instead of stopping the reading, each condition is reported as an event, printed to the demux context output stream,
+    // and the summary counts the events of every indicator
+    //
+    // The monitor keeps a fixed-size state per PID, and does a constant amount of work per packet,
+    // except for the timeouts, which are checked every monitor_sweep_interval_ms of stream time
+    //
+    // Stream time advances by the packet duration with every packet, the duration being derived from the PCRs
+    // (27 MHz ticks over packets between the last two consecutive PCRs of a PID)
+    // Until there have been two consecutive PCRs, times are kept as packet indices, and converted once the packet duration is known
+    // Timeouts are only checked, and events only timestamped, from then on
+    //
+    class Monitor
+    {
+    public:
+        Monitor(const DemuxContext& context, const MonitorOptions& options);
+
+        Monitor(const Monitor&) = delete;
+        Monitor& operator=(const Monitor&) = delete;
+
+        // Checks a packet with a valid sync byte
+        // Returns false if the packet has to be dropped (transport error)
+        bool check(const PacketView& packet, size_t packet_index);
+        // Checks the PES unit of a packet, once it has been processed
+        void check_PES(PID p, size_t packet_index);
+        // Reports an error found while parsing or processing a packet
+        void report_error(ParseError error, std::string_view message, PID p, size_t packet_index);
+        // Reports a packet with an invalid sync byte, and the number of bytes skipped to resynchronize
+        void report_sync_loss(size_t packet_index, size_t skipped_bytes, uint8_t stride);
+
+        [[nodiscard]] uint64_t get_event_count(MonitorCheck check) const { return _event_counts[static_cast<size_t>(check)]; }
+
+        friend std::ostream& operator<<(std::ostream& os, const Monitor& monitor);
+
+    private:
+        // Stream times are in 27 MHz ticks
+        struct PID_State
+        {
+            ContinuityCounter CC{};
+            std::optional<double> last_seen{};
+            std::optional<double> last_section{};
+            std::optional<double> last_PTS_time{};
+            std::optional<uint64_t> last_PTS{};
+            std::optional<uint64_t> last_PCR{};
+            size_t last_PCR_index{ 0 };
+            bool scrambled{ false };
+        };
+
+        void check_PCR(PID_State& state, PID p, uint64_t PCR, bool discontinuity_indicator, size_t packet_index);
+        void check_PSI_section(PID_State& state, PID p, const PacketView& packet, size_t packet_index);
+        // Checks the timeouts of the PAT, PMTs, PIDs and PTSs
+        void sweep(size_t packet_index);
+        void report(MonitorCheck check, size_t packet_index, std::optional<PID> p, std::string details);
+
+        // Stream time of a packet (its index, until the packet duration is known)
+        [[nodiscard]] double get_time(size_t packet_index) const
+        {
+            return _ticks_per_packet
+                ? _clock_time + static_cast<double>(packet_index - _clock_index) * *_ticks_per_packet
+                : static_cast<double>(packet_index);
+        }
+        void set_ticks_per_packet(double ticks_per_packet, size_t packet_index);
+        [[nodiscard]] static uint64_t get_elapsed_ms(double from, double to);
+
+        const DemuxContext& _context;
+        MonitorOptions _options{};
+        std::array<PID_State, PID_count> _states{};  // indexed by PID
+        std::array<uint64_t, monitor_check_count> _event_counts{};
+
+        std::optional<double> _ticks_per_packet{};  // packet duration
+        double _clock_time{ 0 };  // stream time of the packet the packet duration was last set at
+        size_t _clock_index{ 0 };
+        size_t _sweep_packet_count{ 0 };  // packets between sweeps
+        size_t _next_sweep_index{ 0 };
+        std::optional<double> _last_PAT{};
+        size_t _known_PMT_PID_count{ 0 };
+        size_t _known_PES_PID_count{ 0 };
+    };
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef __TS_PES_ASSEMBLER_HPP__
+#define __TS_PES_ASSEMBLER_HPP__
+
+#include "ByteBufferView.hpp"
+#include "Packet.hpp"
+#include "PES_Data.hpp"
+#include "PID_Map.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace TS
+{
+    // Per PID reassembly of PES packets
+    //
+    // A PES packet starts in a TS packet with the payload unit start indicator set
+    // Its header (start code, stream id, PES packet length and, for most stream ids, the optional header with PTS and DTS)
+    // is decoded, and stripped, so that only elementary stream bytes are handed over to PES_Data, as a gather list of spans
+    // of the TS packet buffer (no copies are made)
+    // Only header bytes are copied, and only when the header spans across TS packets
+    //
+    // Payloads received before the first PES packet start, or after an invalid PES header, are dropped until the next start
+    //
+    class PES_Assembler
+    {
+    public:
+        using PID = uint16_t;
+
+        explicit PES_Assembler(PES_Data& PES_data) : _PES_data{ PES_data } {}
+
+        // Processes the payload of a TS packet of a PES PID, and saves the result in PES_Data
+        void assemble(PID p, bool payload_unit_start_indicator, const byte_buffer_view& payload);
+
+        // True if a PES packet has been started on the PID, and may still have elementary stream bytes to come
+        [[nodiscard]] bool is_in_unit(PID p) const;
+
+        [[nodiscard]] size_t get_dropped_unit_count() const { return _dropped_unit_count; }
+
+    private:
+        struct State
+        {
+            bool in_unit{ false };  // a PES packet start has been received, and its header is valid so far
+            bool header_complete{ false };
+            std::array<uint8_t, PES_max_header_size> header{};
+            size_t header_bytes{ 0 };  // header bytes received so far
+            std::optional<size_t> bytes_left{};  // elementary stream bytes left in the PES packet, if bounded
+        };
+
+        // Header size, as far as it can be told from the header bytes received so far
+        [[nodiscard]] static size_t get_header_size(const State& state);
+
+        // Decodes a complete header into the PES unit
+        // Returns false if the header is invalid
+        [[nodiscard]] static bool parse_header(State& state, PES_Unit& unit);
+
+        void drop_unit(State& state);
+
+        PES_Data& _PES_data;
+        PID_Map<State> _states{};
+        size_t _dropped_unit_count{ 0 };
+    };
+}
+
+#endif
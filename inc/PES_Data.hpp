@@ -2,10 +2,12 @@
 #define __TS_PES_DATA_HPP__
 
 #include "ByteBufferView.hpp"
+#include "PID_Map.hpp"
 
-#include <functional>
-#include <map>
+#include <cstdint>
+#include <optional>
 #include <span>
+#include <vector>
 
 namespace TS
 {
@@ -13,24 +15,36 @@ namespace TS
 
     using PID = uint16_t;
 
-    using TPES_map = std::map<PID, byte_buffer_view>;  // PES PID -> PES data
+    // Elementary stream bytes carried by a packet, as a gather list of spans of the packet buffer
+    using ES_gather_list = std::vector<byte_buffer_view>;
+
+    // PES packet currently being received on a PID
+    struct PES_Unit
+    {
+        uint8_t stream_id{ 0 };
+        uint16_t PES_packet_length{ 0 };  // 0 means unbounded (only allowed for video streams)
+        std::optional<uint64_t> PTS{};  // 90 kHz units
+        std::optional<uint64_t> DTS{};  // 90 kHz units
+
+        ES_gather_list ES_data{};  // elementary stream bytes of this PES packet carried by the last processed TS packet
+    };
+
+    using TPES_map = PID_Map<PES_Unit>;  // PES PID -> PES unit
 
     class PES_Data
     {
     public:
+        PES_Data() = default;
         PES_Data(const PES_Data&) = delete;
         PES_Data(PES_Data&) = delete;
         PES_Data& operator=(const PES_Data&) = delete;
         PES_Data& operator=(PES_Data&&) = delete;
 
-        static PES_Data& get_instance();
-
         bool has_PES_data(PID p) const;
-        const byte_buffer_view get_PES_data(PID p) const;
-        void set_PES_data(PID p, const byte_buffer_view& data);
+        const PES_Unit& get_PES_unit(PID p) const;
+        PES_Unit& get_PES_unit(PID p);  // creates the unit if needed
+        const ES_gather_list& get_ES_data(PID p) const;
     private:
-        PES_Data() {}
-
         TPES_map PES_map;
     };
 }
@@ -0,0 +1,39 @@
+#ifndef __TS_PID_FILTER_HPP__
+#define __TS_PID_FILTER_HPP__
+
+#include "Packet.hpp"
+
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace TS
+{
+    // Set of the PIDs we are interested in
+    //
+    // Packets whose PID is not in the set can be dropped just after reading their header,
+    // without parsing or processing them
+    // PSI PIDs are always in the set: PAT, CAT and NIT PIDs from the start, and PMT PIDs as the PAT tables are parsed
+    // Elementary stream PIDs are added as the PMT tables are parsed, if their stream type is one of the requested ones
+    //
+    class PID_Filter
+    {
+    public:
+        using PID = uint16_t;
+        using stream_type = uint8_t;
+
+        PID_Filter(const std::vector<stream_type>& stream_type_list, PID NIT_pid);
+
+        [[nodiscard]] bool contains(PID p) const { return _PIDs[p]; }
+        void add(PID p) { _PIDs[p] = true; }
+
+        // Adds the PIDs resolved by the PAT or PMT table contained in the packet, if any
+        void add_table_PIDs(const Packet& packet);
+
+    private:
+        std::bitset<PID_count> _PIDs{};
+        std::vector<stream_type> _stream_type_list{};
+    };
+}
+
+#endif
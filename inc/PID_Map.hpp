@@ -0,0 +1,71 @@
+#ifndef __TS_PID_MAP_HPP__
+#define __TS_PID_MAP_HPP__
+
+#include "Packet.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace TS
+{
+    // Map keyed by PID, with O(1) lookups
+    //
+    // PIDs are 13-bit values, so a dense array of 8192 slot indices (16 KB) tells where the value of each PID is stored,
+    // while the values themselves are kept compact, only one per PID in the map
+    // Values are stored in a deque, so references to them stay valid when other PIDs are added (as with std::map)
+    // PIDs can't be removed, as tables keyed by PID only ever grow while a stream is demuxed
+    //
+    template <typename T>
+    class PID_Map
+    {
+    public:
+        using PID = uint16_t;
+
+        PID_Map() { _slots.fill(no_slot); }
+
+        [[nodiscard]] bool contains(PID p) const { return _slots[p] != no_slot; }
+        [[nodiscard]] size_t size() const { return _values.size(); }
+        [[nodiscard]] bool empty() const { return _values.empty(); }
+
+        // Creates a value-initialized entry if the PID is not in the map
+        T& operator[](PID p)
+        {
+            if (not contains(p))
+            {
+                _slots[p] = static_cast<uint16_t>(_values.size());
+                _values.emplace_back();
+                _PIDs.push_back(p);
+            }
+            return _values[_slots[p]];
+        }
+
+        // Throw std::out_of_range if the PID is not in the map
+        T& at(PID p) { check(p); return _values[_slots[p]]; }
+        const T& at(PID p) const { check(p); return _values[_slots[p]]; }
+
+        // PIDs in the map, in the order they were added
+        [[nodiscard]] const std::vector<PID>& get_PIDs() const { return _PIDs; }
+
+    private:
+        static constexpr uint16_t no_slot{ std::numeric_limits<uint16_t>::max() };
+
+        void check(PID p) const
+        {
+            if (not contains(p))
+            {
+                throw std::out_of_range{ "PID not found" };
+            }
+        }
+
+        std::array<uint16_t, PID_count> _slots{};
+        std::deque<T> _values{};
+        std::vector<PID> _PIDs{};
+    };
+}
+
+#endif
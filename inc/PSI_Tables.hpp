@@ -1,6 +1,11 @@
 #ifndef __TS_PSI_TABLES_HPP__
 #define __TS_PSI_TABLES_HPP__
 
+#include "ParseResult.hpp"
+#include "PID_Map.hpp"
+
+#include <bitset>
+#include <cstdint>
 #include <map>
 
 namespace TS
@@ -11,21 +16,30 @@ namespace TS
     using program_number = uint16_t;
     using stream_type = uint8_t;
 
-    using TPAT_map = std::map<PID, program_number>;  // PMT PID -> program number
+    // Tables looked up for every packet are indexed by PID, with O(1) lookups
+    using TPAT_map = PID_Map<program_number>;  // PMT PID -> program number
     using TPMT_map = std::map<PID, stream_type>;  // PES PID -> stream type (PMT level)
-    using TPES_stream_type_cache_map = std::map<PID, stream_type>;  // PES PID -> stream type (TS file level)
+    using TPES_stream_type_cache_map = PID_Map<stream_type>;  // PES PID -> stream type (TS file level)
 
 
     class PSI_Tables
     {
     private:
+        // Tables can be split in several sections (up to 256), all of them sharing the same version number
         class PSI_Table
         {
         public:
-            bool needs_update(uint8_t version);
+            bool needs_update(uint8_t version, uint8_t section_number, uint8_t last_section_number);
+            // True once all the sections of the current version have been processed
+            [[nodiscard]] bool is_complete() const
+            {
+                return _initialized and _sections.count() == _last_section_number + 1u;
+            }
         private:
             bool _initialized{ false };
             uint8_t _version{ 0 };
+            uint8_t _last_section_number{ 0 };
+            std::bitset<256> _sections{};  // sections of the current version already processed
         };
 
         class PAT_Table : public PSI_Table
@@ -35,6 +49,7 @@ namespace TS
             [[nodiscard]] bool contains(PID p) const { return PAT_map.contains(p); }
             program_number& operator[](PID p) { return PAT_map[p]; }
             program_number at(PID p) const { return PAT_map.at(p); }
+            [[nodiscard]] const TPAT_map& get_map() const { return PAT_map; }
         private:
             TPAT_map PAT_map{};
         };
@@ -59,36 +74,51 @@ namespace TS
             [[nodiscard]] bool contains(PID p) const { return PES_stream_type_cache_map.contains(p); }
             stream_type& operator[](PID p) { return PES_stream_type_cache_map[p]; }
             stream_type at(PID p) const { return PES_stream_type_cache_map.at(p); }
+            [[nodiscard]] const TPES_stream_type_cache_map& get_map() const { return PES_stream_type_cache_map; }
         private:
             TPES_stream_type_cache_map PES_stream_type_cache_map{};
         };
     
     public:
+        PSI_Tables() = default;
         PSI_Tables(const PSI_Tables&) = delete;
         PSI_Tables(PSI_Tables&) = delete;
         PSI_Tables& operator=(const PSI_Tables&) = delete;
         PSI_Tables& operator=(PSI_Tables&&) = delete;
 
-        static PSI_Tables& get_instance();
-
         program_number get_PAT_program_number(PID p) const;
         stream_type get_PES_stream_type(PID p) const;
+        program_number get_PES_program_number(PID p) const;
 
-        void set_PAT_program_number(PID p, program_number n);
-        void set_PMT_stream_type(program_number n, PID p, stream_type st);
+        // Return an error if the PID is already declared, or the program is unknown, without updating the tables
+        ParseResult set_PAT_program_number(PID p, program_number n);
+        ParseResult set_PMT_stream_type(program_number n, PID p, stream_type st);
 
-        [[nodiscard]] bool PAT_needs_update(uint8_t version) { return PAT_table.needs_update(version); }
-        [[nodiscard]] bool PMT_needs_update(program_number n, uint8_t version) { return PMT_tables[n].needs_update(version); }
+        [[nodiscard]] bool PAT_needs_update(uint8_t version, uint8_t section_number, uint8_t last_section_number)
+        {
+            return PAT_table.needs_update(version, section_number, last_section_number);
+        }
+        [[nodiscard]] bool PMT_needs_update(program_number n, uint8_t version, uint8_t section_number, uint8_t last_section_number)
+        {
+            return PMT_tables[n].needs_update(version, section_number, last_section_number);
+        }
 
         bool is_PMT_PID(PID p) const;
         bool is_PES_PID(PID p) const;
+
+        // True once the PAT, and the PMTs of all its programs, have been completely processed
+        [[nodiscard]] bool is_complete() const;
+
+        // PMT PID -> program number, for all the PMT PIDs known so far (the NIT PID too, as program 0)
+        [[nodiscard]] const TPAT_map& get_PMT_program_numbers() const { return PAT_table.get_map(); }
+        // PES PID -> stream type, for all the PES PIDs known so far
+        [[nodiscard]] const TPES_stream_type_cache_map& get_PES_stream_types() const { return PES_stream_type_cache_table.get_map(); }
     
     private:
-        PSI_Tables() {}
-
         PAT_Table PAT_table{};
         std::map<program_number, PMT_Table> PMT_tables{};
         PES_Stream_Type_Cache PES_stream_type_cache_table{};
+        PID_Map<program_number> PES_program_numbers{};  // PES PID -> program number
     };
 }
 
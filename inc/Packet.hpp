@@ -1,17 +1,17 @@
 #ifndef __TS_PACKET_HPP__
 #define __TS_PACKET_HPP__
 
+#include "BitField.hpp"
 #include "ByteBufferView.hpp"
 
 #include <cstdint>
 #include <iostream>
+#include <memory_resource>
 #include <optional>
 #include <variant>
 #include <span>
 #include <vector>
 
-#include <boost/dynamic_bitset/dynamic_bitset.hpp>
-
 namespace TS
 {
     // Sizes (in bytes)
@@ -59,6 +59,11 @@ namespace TS
     constexpr uint8_t ESSD_header_size{ 5 };
     // Descriptors
     constexpr uint8_t descriptor_header_size{ 2 };
+    // PES header
+    constexpr uint8_t PES_header_size{ 6 };
+    constexpr uint8_t PES_optional_header_size{ 3 };
+    constexpr uint8_t PES_timestamp_size{ 5 };
+    constexpr uint16_t PES_max_header_size{ PES_header_size + PES_optional_header_size + 255 };
 
 
 
@@ -70,6 +75,8 @@ namespace TS
     constexpr uint16_t PAT_PID{ 0 };
     constexpr uint16_t CAT_PID{ 1 };
     constexpr uint16_t default_NIT_PID{ 0x10 };
+    constexpr uint16_t null_PID{ 0x1fff };
+    constexpr size_t PID_count{ 0x2000 };  // PIDs are 13-bit values
     // Table IDs
     constexpr uint8_t PAT_table_id{ 0 };
     constexpr uint8_t CAT_table_id{ 1 };
@@ -78,6 +85,20 @@ namespace TS
     constexpr uint16_t NIT_program_num{ 0 };
     // Tags
     constexpr uint8_t language_tag{ 0xa };
+    // PES
+    constexpr uint32_t PES_start_code_prefix{ 0x000001 };
+    constexpr uint8_t PES_optional_header_marker_bits{ 0b10 };
+    constexpr uint8_t PES_PTS_flag{ 0b10 };
+    constexpr uint8_t PES_PTS_DTS_flags{ 0b11 };
+    // Stream IDs
+    constexpr uint8_t program_stream_map_stream_id{ 0xbc };
+    constexpr uint8_t padding_stream_id{ 0xbe };
+    constexpr uint8_t private_stream_2_stream_id{ 0xbf };
+    constexpr uint8_t ECM_stream_id{ 0xf0 };
+    constexpr uint8_t EMM_stream_id{ 0xf1 };
+    constexpr uint8_t DSMCC_stream_id{ 0xf2 };
+    constexpr uint8_t H222_1_type_E_stream_id{ 0xf8 };
+    constexpr uint8_t program_stream_directory_stream_id{ 0xff };
 
 
 
@@ -86,208 +107,130 @@ namespace TS
     class NIT_PID
     {
     public:
+        NIT_PID() = default;
         NIT_PID(const NIT_PID&) = delete;
         NIT_PID(NIT_PID&) = delete;
         NIT_PID& operator=(const NIT_PID&) = delete;
         NIT_PID& operator=(NIT_PID&&) = delete;
 
-        static NIT_PID& get_instance();
-
-        uint16_t get_NIT_PID();
+        uint16_t get_NIT_PID() const;
         void set_NIT_PID(uint16_t value);
     private:
-        NIT_PID() {}
-
         uint16_t _value{ default_NIT_PID };
     };
 
 
 
-    // Masks
+    // Fields
+    //
+    // Each field is described by the position it takes within the chunk of bytes read for its section
+    // See BitField.hpp
     //
     // Header
-    const std::array<uint8_t, 4> hdr_sync_byte_mask_array{ 0xff, 0x00, 0x00, 0x00 };
-    const std::array<uint8_t, 4> hdr_transport_error_indicator_mask_array{ 0x00, 0x80, 0x00, 0x00 };
-    const std::array<uint8_t, 4> hdr_payload_unit_start_indicator_mask_array{ 0x00, 0x40, 0x00, 0x00 };
-    const std::array<uint8_t, 4> hdr_transport_priority_mask_array{ 0x00, 0x20, 0x00, 0x00 };
-    const std::array<uint8_t, 4> hdr_PID_mask_array{ 0x00, 0x1f, 0xff, 0x00 };
-    const std::array<uint8_t, 4> hdr_transport_scrambling_control_mask_array{ 0x00, 0x00, 0x00, 0xc0 };
-    const std::array<uint8_t, 4> hdr_adaptation_field_control_mask_array{ 0x00, 0x00, 0x00, 0x30 };
-    const std::array<uint8_t, 4> hdr_continuity_counter_mask_array{ 0x00, 0x00, 0x00, 0x0f };
-
-    const boost::dynamic_bitset<uint8_t> hdr_sync_byte_mask_bs{
-        cbegin(hdr_sync_byte_mask_array), cend(hdr_sync_byte_mask_array) };
-    const boost::dynamic_bitset<uint8_t> hdr_transport_error_indicator_mask_bs{
-        cbegin(hdr_transport_error_indicator_mask_array), cend(hdr_transport_error_indicator_mask_array) };
-    const boost::dynamic_bitset<uint8_t> hdr_payload_unit_start_indicator_mask_bs{
-        cbegin(hdr_payload_unit_start_indicator_mask_array), cend(hdr_payload_unit_start_indicator_mask_array) };
-    const boost::dynamic_bitset<uint8_t> hdr_transport_priority_mask_bs{
-        cbegin(hdr_transport_priority_mask_array), cend(hdr_transport_priority_mask_array) };
-    const boost::dynamic_bitset<uint8_t> hdr_PID_mask_bs{
-        cbegin(hdr_PID_mask_array), cend(hdr_PID_mask_array) };
-    const boost::dynamic_bitset<uint8_t> hdr_transport_scrambling_control_mask_bs{
-        cbegin(hdr_transport_scrambling_control_mask_array), cend(hdr_transport_scrambling_control_mask_array) };
-    const boost::dynamic_bitset<uint8_t> hdr_adaptation_field_control_mask_bs{
-        cbegin(hdr_adaptation_field_control_mask_array), cend(hdr_adaptation_field_control_mask_array) };
-    const boost::dynamic_bitset<uint8_t> hdr_continuity_counter_mask_bs{
-        cbegin(hdr_continuity_counter_mask_array), cend(hdr_continuity_counter_mask_array) };
+    constexpr bit_field<uint8_t, 0, 0, 8> hdr_sync_byte_field{};
+    constexpr bit_field<bool, 1, 7, 1> hdr_transport_error_indicator_field{};
+    constexpr bit_field<bool, 1, 6, 1> hdr_payload_unit_start_indicator_field{};
+    constexpr bit_field<bool, 1, 5, 1> hdr_transport_priority_field{};
+    constexpr bit_field<uint16_t, 1, 0, 13> hdr_PID_field{};
+    constexpr bit_field<uint8_t, 3, 6, 2> hdr_transport_scrambling_control_field{};
+    constexpr bit_field<uint8_t, 3, 4, 2> hdr_adaptation_field_control_field{};
+    constexpr bit_field<uint8_t, 3, 0, 4> hdr_continuity_counter_field{};
 
     // Adaptation field
-    const boost::dynamic_bitset<uint8_t> af_discontinuity_indicator_mask_bs{ 8, 0x80 };
-    const boost::dynamic_bitset<uint8_t> af_random_access_indicator_mask_bs{ 8, 0x40 };
-    const boost::dynamic_bitset<uint8_t> af_elementary_stream_priority_indicator_mask_bs{ 8, 0x20 };
-    const boost::dynamic_bitset<uint8_t> af_PCR_flag_mask_bs{ 8, 0x10 };
-    const boost::dynamic_bitset<uint8_t> af_OPCR_flag_mask_bs{ 8, 0x08 };
-    const boost::dynamic_bitset<uint8_t> af_splicing_point_flag_mask_bs{ 8, 0x04 };
-    const boost::dynamic_bitset<uint8_t> af_transport_private_data_flag_mask_bs{ 8, 0x02 };
-    const boost::dynamic_bitset<uint8_t> af_extension_flag_mask_bs{ 8, 0x01 };
+    constexpr bit_field<bool, 0, 7, 1> af_discontinuity_indicator_field{};
+    constexpr bit_field<bool, 0, 6, 1> af_random_access_indicator_field{};
+    constexpr bit_field<bool, 0, 5, 1> af_elementary_stream_priority_indicator_field{};
+    constexpr bit_field<bool, 0, 4, 1> af_PCR_flag_field{};
+    constexpr bit_field<bool, 0, 3, 1> af_OPCR_flag_field{};
+    constexpr bit_field<bool, 0, 2, 1> af_splicing_point_flag_field{};
+    constexpr bit_field<bool, 0, 1, 1> af_transport_private_data_flag_field{};
+    constexpr bit_field<bool, 0, 0, 1> af_extension_flag_field{};
+
+    // Adaptation field optional
+    constexpr bit_field<uint64_t, 0, 7, 33> afo_PCR_base_field{};
+    constexpr bit_field<uint8_t, 4, 1, 6> afo_PCR_reserved_field{};
+    constexpr bit_field<uint16_t, 4, 0, 9> afo_PCR_extension_field{};
 
     // Adaptation extension
-    const std::array<uint8_t, 2> ae_length_mask_array{ 0xff, 0x00};
-    const std::array<uint8_t, 2> ae_legal_time_window_flag_mask_array{ 0x00, 0x80 };
-    const std::array<uint8_t, 2> ae_piecewise_rate_flag_mask_array{ 0x00, 0x40 };
-    const std::array<uint8_t, 2> ae_seamless_splice_flag_mask_array{ 0x00, 0x20 };
-    const std::array<uint8_t, 2> ae_reserved_mask_array{ 0x00, 0x1f };
-
-    const boost::dynamic_bitset<uint8_t> ae_length_mask_bs{
-        cbegin(ae_length_mask_array), cend(ae_length_mask_array) };
-    const boost::dynamic_bitset<uint8_t> ae_legal_time_window_flag_mask_bs{
-        cbegin(ae_legal_time_window_flag_mask_array), cend(ae_legal_time_window_flag_mask_array) };
-    const boost::dynamic_bitset<uint8_t> ae_piecewise_rate_flag_mask_bs{
-        cbegin(ae_piecewise_rate_flag_mask_array), cend(ae_piecewise_rate_flag_mask_array) };
-    const boost::dynamic_bitset<uint8_t> ae_seamless_splice_flag_mask_bs{
-        cbegin(ae_seamless_splice_flag_mask_array), cend(ae_seamless_splice_flag_mask_array) };
-    const boost::dynamic_bitset<uint8_t> ae_reserved_mask_bs{
-        cbegin(ae_reserved_mask_array), cend(ae_reserved_mask_array) };
+    constexpr bit_field<uint8_t, 0, 0, 8> ae_length_field{};
+    constexpr bit_field<bool, 1, 7, 1> ae_legal_time_window_flag_field{};
+    constexpr bit_field<bool, 1, 6, 1> ae_piecewise_rate_flag_field{};
+    constexpr bit_field<bool, 1, 5, 1> ae_seamless_splice_flag_field{};
+    constexpr bit_field<uint8_t, 1, 0, 5> ae_reserved_field{};
 
     // Adaptation extension optional
-    const std::array<uint8_t, 2> aeo_legal_time_window_valid_flag_mask_array{ 0x80, 0x00 };
-    const std::array<uint8_t, 2> aeo_legal_time_window_offset_mask_array{ 0x7f, 0xff };
-    const std::array<uint8_t, 3> aeo_piecewise_rate_reserved_mask_array{ 0xc0, 0x00, 0x00 };
-    const std::array<uint8_t, 3> aeo_piecewise_rate_mask_array{ 0x3f, 0xff, 0xff };
-    const std::array<uint8_t, 5> aeo_seamless_splice_type_mask_array{ 0xf0, 0x00, 0x00, 0x00, 0x00 };
-    const std::array<uint8_t, 5> aeo_DTS_next_access_unit_mask_array{ 0x0e, 0xff, 0xfe, 0xff, 0xfe };
-
-    const boost::dynamic_bitset<uint8_t> aeo_legal_time_window_valid_flag_mask_bs{
-        cbegin(aeo_legal_time_window_valid_flag_mask_array), cend(aeo_legal_time_window_valid_flag_mask_array) };
-    const boost::dynamic_bitset<uint8_t> aeo_legal_time_window_offset_mask_bs{
-        cbegin(aeo_legal_time_window_offset_mask_array), cend(aeo_legal_time_window_offset_mask_array) };
-    const boost::dynamic_bitset<uint8_t> aeo_piecewise_rate_reserved_mask_bs{
-        cbegin(aeo_piecewise_rate_reserved_mask_array), cend(aeo_piecewise_rate_reserved_mask_array) };
-    const boost::dynamic_bitset<uint8_t> aeo_piecewise_rate_mask_bs{
-        cbegin(aeo_piecewise_rate_mask_array), cend(aeo_piecewise_rate_mask_array) };
-    const boost::dynamic_bitset<uint8_t> aeo_seamless_splice_type_mask_bs{
-        cbegin(aeo_seamless_splice_type_mask_array), cend(aeo_seamless_splice_type_mask_array) };
-    const boost::dynamic_bitset<uint8_t> aeo_DTS_next_access_unit_mask_bs{
-        cbegin(aeo_DTS_next_access_unit_mask_array), cend(aeo_DTS_next_access_unit_mask_array) };
+    constexpr bit_field<bool, 0, 7, 1> aeo_legal_time_window_valid_flag_field{};
+    constexpr bit_field<uint16_t, 0, 0, 15> aeo_legal_time_window_offset_field{};
+    constexpr bit_field<uint8_t, 0, 6, 2> aeo_piecewise_rate_reserved_field{};
+    constexpr bit_field<uint32_t, 0, 0, 22> aeo_piecewise_rate_field{};
+    constexpr bit_field<uint8_t, 0, 4, 4> aeo_seamless_splice_type_field{};
+    // DTS next access unit is split in three chunks, each of them followed by a marker bit
+    constexpr bit_field<uint8_t, 0, 1, 3> aeo_DTS_next_access_unit_32_30_field{};
+    constexpr bit_field<uint16_t, 1, 1, 15> aeo_DTS_next_access_unit_29_15_field{};
+    constexpr bit_field<uint16_t, 3, 1, 15> aeo_DTS_next_access_unit_14_0_field{};
 
     // Table header
-    const std::array<uint8_t, 3> th_table_id_mask_array{ 0xff, 0x00, 0x00 };
-    const std::array<uint8_t, 3> th_section_syntax_indicator_mask_array{ 0x00, 0x80, 0x00 };
-    const std::array<uint8_t, 3> th_private_bit_mask_array{ 0x00, 0x40, 0x00 };
-    const std::array<uint8_t, 3> th_reserved_bits_mask_array{ 0x00, 0x30, 0x00 };
-    const std::array<uint8_t, 3> th_section_length_unused_bits_mask_array{ 0x00, 0x0c, 0x00 };
-    const std::array<uint8_t, 3> th_section_length_mask_array{ 0x00, 0x03, 0xff };
-
-    const boost::dynamic_bitset<uint8_t> th_table_id_mask_bs{
-        cbegin(th_table_id_mask_array), cend(th_table_id_mask_array) };
-    const boost::dynamic_bitset<uint8_t> th_section_syntax_indicator_mask_bs{
-        cbegin(th_section_syntax_indicator_mask_array), cend(th_section_syntax_indicator_mask_array) };
-    const boost::dynamic_bitset<uint8_t> th_private_bit_mask_bs{
-        cbegin(th_private_bit_mask_array), cend(th_private_bit_mask_array) };
-    const boost::dynamic_bitset<uint8_t> th_reserved_bits_mask_bs{
-        cbegin(th_reserved_bits_mask_array), cend(th_reserved_bits_mask_array) };
-    const boost::dynamic_bitset<uint8_t> th_section_length_unused_bits_mask_bs{
-        cbegin(th_section_length_unused_bits_mask_array), cend(th_section_length_unused_bits_mask_array) };
-    const boost::dynamic_bitset<uint8_t> th_section_length_mask_bs{
-        cbegin(th_section_length_mask_array), cend(th_section_length_mask_array) };
+    constexpr bit_field<uint8_t, 0, 0, 8> th_table_id_field{};
+    constexpr bit_field<bool, 1, 7, 1> th_section_syntax_indicator_field{};
+    constexpr bit_field<bool, 1, 6, 1> th_private_bit_field{};
+    constexpr bit_field<uint8_t, 1, 4, 2> th_reserved_bits_field{};
+    constexpr bit_field<uint8_t, 1, 2, 2> th_section_length_unused_bits_field{};
+    constexpr bit_field<uint16_t, 1, 0, 10> th_section_length_field{};
 
     // Table syntax section
-    const std::array<uint8_t, 5> tss_table_id_extension_mask_array{ 0xff, 0xff, 0x00, 0x00, 0x00 };
-    const std::array<uint8_t, 5> tss_reserved_bits_mask_array{ 0x00, 0x00, 0xc0, 0x00, 0x00 };
-    const std::array<uint8_t, 5> tss_version_number_mask_array{ 0x00, 0x00, 0x3e, 0x00, 0x00 };
-    const std::array<uint8_t, 5> tss_current_next_indicator_mask_array{ 0x00, 0x00, 0x01, 0x00, 0x00 };
-    const std::array<uint8_t, 5> tss_section_number_mask_array{ 0x00, 0x00, 0x00, 0xff, 0x00 };
-    const std::array<uint8_t, 5> tss_last_section_number_mask_array{ 0x00, 0x00, 0x00, 0x00, 0xff };
-    const std::array<uint8_t, 4> tss_crc32_mask_array{ 0xff, 0xff, 0xff, 0xff };
-
-    const boost::dynamic_bitset<uint8_t> tss_table_id_extension_mask_bs{
-        cbegin(tss_table_id_extension_mask_array), cend(tss_table_id_extension_mask_array) };
-    const boost::dynamic_bitset<uint8_t> tss_reserved_bits_mask_bs{
-        cbegin(tss_reserved_bits_mask_array), cend(tss_reserved_bits_mask_array) };
-    const boost::dynamic_bitset<uint8_t> tss_version_number_mask_bs{
-        cbegin(tss_version_number_mask_array), cend(tss_version_number_mask_array) };
-    const boost::dynamic_bitset<uint8_t> tss_current_next_indicator_mask_bs{
-        cbegin(tss_current_next_indicator_mask_array), cend(tss_current_next_indicator_mask_array) };
-    const boost::dynamic_bitset<uint8_t> tss_section_number_mask_bs{
-        cbegin(tss_section_number_mask_array), cend(tss_section_number_mask_array) };
-    const boost::dynamic_bitset<uint8_t> tss_last_section_number_mask_bs{
-        cbegin(tss_last_section_number_mask_array), cend(tss_last_section_number_mask_array) };
-    const boost::dynamic_bitset<uint8_t> tss_crc32_mask_bs{
-        cbegin(tss_crc32_mask_array), cend(tss_crc32_mask_array) };
+    constexpr bit_field<uint16_t, 0, 0, 16> tss_table_id_extension_field{};
+    constexpr bit_field<uint8_t, 2, 6, 2> tss_reserved_bits_field{};
+    constexpr bit_field<uint8_t, 2, 1, 5> tss_version_number_field{};
+    constexpr bit_field<bool, 2, 0, 1> tss_current_next_indicator_field{};
+    constexpr bit_field<uint8_t, 3, 0, 8> tss_section_number_field{};
+    constexpr bit_field<uint8_t, 4, 0, 8> tss_last_section_number_field{};
+    constexpr bit_field<uint32_t, 0, 0, 32> tss_crc32_field{};
 
     // PAT table
-    const std::array<uint8_t, 4> PAT_table_data_table_id_extension_mask_array{ 0xff, 0xff, 0x00, 0x00 };
-    const std::array<uint8_t, 4> PAT_table_data_reserved_bits_mask_array{ 0x00, 0x00, 0xe0, 0x00 };
-    const std::array<uint8_t, 4> PAT_table_data_program_map_PID_mask_array{ 0x00, 0x00, 0x1f, 0xff };
-
-    const boost::dynamic_bitset<uint8_t> PAT_table_data_table_id_extension_mask_bs{
-        cbegin(PAT_table_data_table_id_extension_mask_array), cend(PAT_table_data_table_id_extension_mask_array) };
-    const boost::dynamic_bitset<uint8_t> PAT_table_data_reserved_bits_mask_bs{
-        cbegin(PAT_table_data_reserved_bits_mask_array), cend(PAT_table_data_reserved_bits_mask_array) };
-    const boost::dynamic_bitset<uint8_t> PAT_table_data_program_map_PID_mask_bs{
-        cbegin(PAT_table_data_program_map_PID_mask_array), cend(PAT_table_data_program_map_PID_mask_array) };
+    constexpr bit_field<uint16_t, 0, 0, 16> PAT_table_data_program_num_field{};
+    constexpr bit_field<uint8_t, 2, 5, 3> PAT_table_data_reserved_bits_field{};
+    constexpr bit_field<uint16_t, 2, 0, 13> PAT_table_data_program_map_PID_field{};
 
     // PMT table
-    const std::array<uint8_t, 4> PMT_reserved_bits_mask_array{ 0xe0, 0x00, 0x00, 0x00 };
-    const std::array<uint8_t, 4> PMT_PCR_PID_mask_array{ 0x1f, 0xff, 0x00, 0x00 };
-    const std::array<uint8_t, 4> PMT_reserved_bits_2_mask_array{ 0x00, 0x00, 0xf0, 0x00 };
-    const std::array<uint8_t, 4> PMT_program_info_length_unused_bits_mask_array{ 0x00, 0x00, 0x0c, 0x00 };
-    const std::array<uint8_t, 4> PMT_program_info_length_array{ 0x00, 0x00, 0x03, 0xff };
-
-    const boost::dynamic_bitset<uint8_t> PMT_reserved_bits_mask_bs{
-        cbegin(PMT_reserved_bits_mask_array), cend(PMT_reserved_bits_mask_array) };
-    const boost::dynamic_bitset<uint8_t> PMT_PCR_PID_mask_bs{
-        cbegin(PMT_PCR_PID_mask_array), cend(PMT_PCR_PID_mask_array) };
-    const boost::dynamic_bitset<uint8_t> PMT_reserved_bits_2_mask_bs{
-        cbegin(PMT_reserved_bits_2_mask_array), cend(PMT_reserved_bits_2_mask_array) };
-    const boost::dynamic_bitset<uint8_t> PMT_program_info_length_unused_bits_mask_bs{
-        cbegin(PMT_program_info_length_unused_bits_mask_array), cend(PMT_program_info_length_unused_bits_mask_array) };
-    const boost::dynamic_bitset<uint8_t> PMT_program_info_length_bs{
-        cbegin(PMT_program_info_length_array), cend(PMT_program_info_length_array) };
+    constexpr bit_field<uint8_t, 0, 5, 3> PMT_reserved_bits_field{};
+    constexpr bit_field<uint16_t, 0, 0, 13> PMT_PCR_PID_field{};
+    constexpr bit_field<uint8_t, 2, 4, 4> PMT_reserved_bits_2_field{};
+    constexpr bit_field<uint8_t, 2, 2, 2> PMT_program_info_length_unused_bits_field{};
+    constexpr bit_field<uint16_t, 2, 0, 10> PMT_program_info_length_field{};
 
     // Elementary stream specific data
-    const std::array<uint8_t, 5> ESSD_stream_type_mask_array{ 0xff, 0x00, 0x00, 0x00, 0x00 };
-    const std::array<uint8_t, 5> ESSD_reserved_bits_mask_array{ 0x00, 0xe0, 0x00, 0x00, 0x00 };
-    const std::array<uint8_t, 5> ESSD_elementary_PID_mask_array{ 0x00, 0x1f, 0xff, 0x00, 0x00 };
-    const std::array<uint8_t, 5> ESSD_reserved_bits_2_mask_array{ 0x00, 0x00, 0x00, 0xf0, 0x00 };
-    const std::array<uint8_t, 5> ESSD_info_length_unused_bits_mask_array{ 0x00, 0x00, 0x00, 0x0c, 0x00 };
-    const std::array<uint8_t, 5> ESSD_info_length_mask_array{ 0x00, 0x00, 0x00, 0x03, 0xff };
-
-    const boost::dynamic_bitset<uint8_t> ESSD_stream_type_mask_bs{
-        cbegin(ESSD_stream_type_mask_array), cend(ESSD_stream_type_mask_array) };
-    const boost::dynamic_bitset<uint8_t> ESSD_reserved_bits_mask_bs{
-        cbegin(ESSD_reserved_bits_mask_array), cend(ESSD_reserved_bits_mask_array) };
-    const boost::dynamic_bitset<uint8_t> ESSD_elementary_PID_mask_bs{
-        cbegin(ESSD_elementary_PID_mask_array), cend(ESSD_elementary_PID_mask_array) };
-    const boost::dynamic_bitset<uint8_t> ESSD_reserved_bits_2_mask_bs{
-        cbegin(ESSD_reserved_bits_2_mask_array), cend(ESSD_reserved_bits_2_mask_array) };
-    const boost::dynamic_bitset<uint8_t> ESSD_info_length_unused_bits_mask_bs{
-        cbegin(ESSD_info_length_unused_bits_mask_array), cend(ESSD_info_length_unused_bits_mask_array) };
-    const boost::dynamic_bitset<uint8_t> ESSD_info_length_mask_bs{
-        cbegin(ESSD_info_length_mask_array), cend(ESSD_info_length_mask_array) };
+    constexpr bit_field<uint8_t, 0, 0, 8> ESSD_stream_type_field{};
+    constexpr bit_field<uint8_t, 1, 5, 3> ESSD_reserved_bits_field{};
+    constexpr bit_field<uint16_t, 1, 0, 13> ESSD_elementary_PID_field{};
+    constexpr bit_field<uint8_t, 3, 4, 4> ESSD_reserved_bits_2_field{};
+    constexpr bit_field<uint8_t, 3, 2, 2> ESSD_info_length_unused_bits_field{};
+    constexpr bit_field<uint16_t, 3, 0, 10> ESSD_info_length_field{};
 
     // Descriptors
-    const std::array<uint8_t, 2> dsc_tag_mask_array{ 0xff, 0x00 };
-    const std::array<uint8_t, 2> dsc_length_mask_array{ 0x00, 0xff };
+    constexpr bit_field<uint8_t, 0, 0, 8> dsc_tag_field{};
+    constexpr bit_field<uint8_t, 1, 0, 8> dsc_length_field{};
+
+    // PES header
+    constexpr bit_field<uint32_t, 0, 0, 24> PES_start_code_prefix_field{};
+    constexpr bit_field<uint8_t, 3, 0, 8> PES_stream_id_field{};
+    constexpr bit_field<uint16_t, 4, 0, 16> PES_packet_length_field{};
 
-    const boost::dynamic_bitset<uint8_t> dsc_tag_mask_bs{ cbegin(dsc_tag_mask_array), cend(dsc_tag_mask_array) };
-    const boost::dynamic_bitset<uint8_t> dsc_length_mask_bs{ cbegin(dsc_length_mask_array), cend(dsc_length_mask_array) };
+    // PES optional header
+    constexpr bit_field<uint8_t, 0, 6, 2> PES_marker_bits_field{};
+    constexpr bit_field<uint8_t, 1, 6, 2> PES_PTS_DTS_flags_field{};
+    constexpr bit_field<uint8_t, 2, 0, 8> PES_header_data_length_field{};
+
+    // Reads a 33-bit timestamp (DTS next access unit, PTS or DTS) from its 5 bytes
+    // PTS and DTS share the DTS next access unit layout: a 4-bit prefix, and then three chunks, each followed by a marker bit
+    [[nodiscard]] uint64_t read_timestamp(const byte_buffer_view& buffer);
 
 
 
     // Structs
     //
+    // Variable-sized parse products (sections, PAT programs, ESSDs and descriptors) are allocated from the arena of the parser
+    // (see ParseArena.hpp), so they are only valid until the parser is asked for the next packet
+    //
     struct Descriptor
     {
         uint8_t tag{ 0 };
@@ -300,7 +243,7 @@ namespace TS
         uint8_t stream_type{ 0 };
         uint16_t elementary_PID{ 0 };
         uint16_t info_length{ 0 };
-        std::optional<std::vector<Descriptor>> descriptors{};
+        std::optional<std::pmr::vector<Descriptor>> descriptors{};
     };
 
     struct PMT_Table
@@ -308,8 +251,8 @@ namespace TS
         uint16_t PCR_PID{ 0 };
         uint16_t program_info_length{ 0 };
 
-        std::optional<std::vector<Descriptor>> program_descriptors{};
-        std::optional<std::vector<ESSD>> ESSD_info_data{};
+        std::optional<std::pmr::vector<Descriptor>> program_descriptors{};
+        std::optional<std::pmr::vector<ESSD>> ESSD_info_data{};
     };
 
     struct PAT_Table
@@ -317,7 +260,7 @@ namespace TS
         using program_num = uint16_t;
         using program_map_PID = uint16_t;
 
-        std::vector<std::pair<program_num, program_map_PID>> data{};
+        std::pmr::vector<std::pair<program_num, program_map_PID>> data{};
     };
 
     struct TableSyntax
@@ -355,7 +298,7 @@ namespace TS
     struct PayloadData
     {
         std::optional<Pointer> pointer{};
-        std::optional<TableHeader> table_header{};
+        std::pmr::vector<TableHeader> table_headers{};  // sections completed in this packet
         std::optional<byte_buffer_view> PES_data{};
 
         bool has_PES_data() const;
@@ -395,10 +338,22 @@ namespace TS
         friend std::ostream& operator<<(std::ostream& os, const AdaptationFieldFlags& aff);
     };
 
+    // PCRs tick at 27 MHz, and wrap around at 2^33 90 kHz units, i.e. 2^33 * 300 27 MHz units (about 26.5 hours)
+    constexpr uint64_t PCR_frequency{ 27'000'000 };
+    constexpr uint64_t PCR_wrap_around{ (uint64_t{ 1 } << 33) * 300 };
+
+    struct ProgramClockReference
+    {
+        uint64_t base{ 0 };  // 90 kHz units
+        uint16_t extension{ 0 };  // 27 MHz units
+
+        [[nodiscard]] uint64_t get_value() const { return base * 300 + extension; }  // 27 MHz units
+    };
+
     struct AdaptationFieldOptional
     {
-        std::optional<boost::dynamic_bitset<uint8_t>> PCR{};
-        std::optional<boost::dynamic_bitset<uint8_t>> OPCR{};
+        std::optional<ProgramClockReference> PCR{};
+        std::optional<ProgramClockReference> OPCR{};
         std::optional<int8_t> splice_countdown{};  // two's complement signed
         std::optional<uint8_t> transport_private_data_length{};
         std::optional<byte_buffer_view> transport_private_data{};
@@ -436,6 +391,9 @@ namespace TS
         Header header{};
         std::optional<AdaptationField> adaptation_field{};
         std::optional<PayloadData> payload_data{};
+        // NIT and PMT PIDs are only known from the PAT tables processed so far, so the parser tells them from its demux context
+        bool carries_NIT{ false };
+        bool carries_PMT{ false };
 
         bool get_payload_unit_start_indicator() const;
         uint16_t get_PID() const;
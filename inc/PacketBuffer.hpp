@@ -2,34 +2,44 @@
 #define __TS_PACKET_BUFFER_HPP__
 
 #include "Packet.hpp"
+#include "PacketLayout.hpp"
 
-#include <array>
-#include <fstream>
 #include <span>
 
-#include <boost/dynamic_bitset/dynamic_bitset.hpp>
-
 namespace TS
 {
-    class PacketBuffer
+    // Packet buffers wrap a stored packet (prefix + TS packet + suffix), as described by its layout
+    // The packet bytes are not owned: they live in the input window (e.g. a read buffer or a memory-mapped file)
+    // Reads, sizes and positions all refer to the TS packet, so parsing doesn't depend on the layout
+    template <typename Layout>
+    class BasicPacketBuffer
     {
     public:
-        char* data_as_char_pointer() { return reinterpret_cast<char*>(_buffer.data()); }
+        using layout = Layout;
+
+        BasicPacketBuffer() = default;
+        explicit BasicPacketBuffer(const byte_buffer_view& record) : _record{ record.data() } {}
+
+        char* data_as_char_pointer() { return reinterpret_cast<char*>(_record + layout::prefix_size); }
+        char* record_as_char_pointer() { return reinterpret_cast<char*>(_record); }
 
         const byte_buffer_view read(uint8_t n);
+        const byte_buffer_view peek(uint8_t n);  // reads without moving the read position
+        const byte_buffer_view prefix() { return { _record, layout::prefix_size }; }
 
         [[nodiscard]] constexpr uint8_t size() const { return packet_size; }
+        [[nodiscard]] constexpr uint8_t record_size() const { return layout::stride; }
         [[nodiscard]] uint8_t size_not_read() const { return packet_size - _pos; }
 
         [[nodiscard]] uint8_t get_read_position() const { return _pos; }
         void reset_read_position() { _pos = 0; }
 
-        friend std::ifstream& operator>>(std::ifstream& ifs, PacketBuffer& pb);
-
     private:
-        std::array<uint8_t, packet_size> _buffer{ 0 };
+        uint8_t* _record{ nullptr };
         uint8_t _pos{ 0 };
     };
+
+    using PacketBuffer = BasicPacketBuffer<TS_188_layout>;
 }
 
 #endif
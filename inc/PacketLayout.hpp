@@ -0,0 +1,32 @@
+#ifndef __TS_PACKET_LAYOUT_HPP__
+#define __TS_PACKET_LAYOUT_HPP__
+
+#include "Packet.hpp"
+
+#include <cstdint>
+
+namespace TS
+{
+    // Packet layouts describe how TS packets are stored in the input
+    //
+    // Every TS packet may be preceded by a prefix and followed by a suffix, e.g.:
+    // - plain TS: 188-byte TS packets,
+    // - M2TS/BDAV: 4-byte timestamp prefix (TP_extra_header) + 188-byte TS packet, and
+    // - TS with Reed-Solomon parity: 188-byte TS packet + 16 parity bytes.
+    //
+    // The stride is the distance between the start of two consecutive stored packets
+    //
+    template <uint8_t PrefixSize, uint8_t SuffixSize>
+    struct packet_layout
+    {
+        static constexpr uint8_t prefix_size{ PrefixSize };
+        static constexpr uint8_t suffix_size{ SuffixSize };
+        static constexpr uint8_t stride{ PrefixSize + packet_size + SuffixSize };
+    };
+
+    using TS_188_layout = packet_layout<0, 0>;
+    using M2TS_192_layout = packet_layout<4, 0>;
+    using TS_204_layout = packet_layout<0, 16>;
+}
+
+#endif
@@ -1,44 +1,85 @@
 #ifndef __TS_PACKET_PARSER_HPP__
 #define __TS_PACKET_PARSER_HPP__
 
+#include "DemuxContext.hpp"
+#include "HeaderTable.hpp"
 #include "Packet.hpp"
 #include "PacketBuffer.hpp"
+#include "ParseArena.hpp"
+#include "ParseResult.hpp"
+#include "SectionAssembler.hpp"
+#include "SectionReader.hpp"
 
 #include <span>
 
 namespace TS
 {
-    class PacketParser
+    // Packet parsers are specialized at compile time for the layout of the packets they parse
+    template <typename Layout>
+    class BasicPacketParser
     {
     public:
-        void parse(PacketBuffer& buffer);
+        using buffer_type = BasicPacketBuffer<Layout>;
+
+        explicit BasicPacketParser(const DemuxContext& context) : _context{ context } {}
+
+        // Returns the first error found in the packet, if any, instead of throwing it
+        // The packet is accounted for whether it could be parsed or not
+        ParseResult parse(buffer_type& buffer);
+        void skip() { _packet_index++; }  // accounts for a packet that is not going to be parsed
         Packet& get_packet() { return _packet; }
-        size_t get_packet_index() { return _packet_index; }
+        size_t get_packet_index() const { return _packet_index; }
+
+        // Error of a section started in a previous packet, and dropped by the packet just parsed (e.g. after lost packets), if any
+        // It is not returned by parse, as the sections starting in the packet are parsed all the same
+        [[nodiscard]] ParseResult get_dropped_section_result() const { return _dropped_section_result; }
+
+        // True if a PSI section spanning across packets is being reassembled for the PID
+        [[nodiscard]] bool is_assembling_section(uint16_t pid) const { return _section_assembler.is_assembling(pid); }
+
+        // Batch API: decodes only the headers of a block of contiguous packets into a structure-of-arrays table
+        // The full parse can then be restricted to the packets that need it
+        static void parse_headers(const byte_buffer_view& packets, HeaderTable& table)
+        {
+            decode_headers(packets, table, Layout::stride, Layout::prefix_size);
+        }
 
     private:
-        static size_t _packet_index;
-
-        void parse_header(PacketBuffer& buffer);
-        void parse_adaptation_field(PacketBuffer& buffer);
-        void parse_adaptation_field_flags(PacketBuffer& buffer);
-        void parse_adaptation_field_optional(PacketBuffer& buffer);
-        void parse_adaptation_extension(PacketBuffer& p_buffer);
-        void parse_payload_data(PacketBuffer& buffer);
-        void parse_payload_data_as_PES(PacketBuffer& p_buffer);
-        void parse_payload_data_as_PSI(PacketBuffer& p_buffer);
-        void parse_pointer(PacketBuffer& buffer);
-        void parse_table_header(PacketBuffer& buffer);
-        bool check_and_parse_stuffing_bytes_section(const byte_buffer_view& buffer) const;
-        bool check_and_parse_stuffing_bytes_section(uint8_t first_byte, uint8_t bytes_to_read, PacketBuffer& p_buffer) const;
-        void parse_table_syntax_section(PacketBuffer& p_buffer);
-        void parse_PAT_table(PacketBuffer& p_buffer);
-        void parse_PMT_table(PacketBuffer& p_buffer);
-        void parse_CRC32(PacketBuffer& p_buffer);
-        void parse_elementary_stream_specific_data(PacketBuffer& p_buffer, uint16_t elementary_stream_specific_data_size);
-        std::vector<Descriptor> parse_descriptors(PacketBuffer& p_buffer, uint16_t descriptors_size);
+        // Lengths read from the packet are checked before reading what they span over,
+        // so that inconsistent lengths are reported as errors instead of overrunning the buffers
+        ParseResult parse_packet(buffer_type& p_buffer);
+        ParseResult parse_header(buffer_type& p_buffer);
+        ParseResult parse_adaptation_field(buffer_type& p_buffer);
+        void parse_adaptation_field_flags(buffer_type& p_buffer);
+        ParseResult parse_adaptation_field_optional(buffer_type& p_buffer);
+        ProgramClockReference parse_program_clock_reference(buffer_type& p_buffer);
+        ParseResult parse_adaptation_extension(buffer_type& p_buffer);
+        ParseResult parse_payload_data(buffer_type& p_buffer);
+        void parse_payload_data_as_PES(buffer_type& p_buffer);
+        ParseResult parse_payload_data_as_PSI(buffer_type& p_buffer);
+        ParseResult parse_pointer(buffer_type& p_buffer);
+        ParseResult parse_stuffing_bytes_section(buffer_type& p_buffer) const;
+
+        // Sections are parsed from a section reader, whether they are contained in the packet or have been reassembled
+        ParseResult parse_section(const byte_buffer_view& section);
+        ParseResult parse_table_header(SectionReader& s_reader);
+        ParseResult parse_table_syntax_section(SectionReader& s_reader);
+        ParseResult parse_PAT_table(SectionReader& s_reader);
+        ParseResult parse_PMT_table(SectionReader& s_reader);
+        void parse_CRC32(SectionReader& s_reader);
+        ParseResult parse_elementary_stream_specific_data(SectionReader& s_reader, uint16_t elementary_stream_specific_data_size);
+        ParseResult parse_descriptors(SectionReader& s_reader, uint16_t descriptors_size, std::pmr::vector<Descriptor>& descriptors);
 
+        const DemuxContext& _context;
+        // Reset for every packet parsed, and declared before _packet, so that it outlives the parsed products pointing into it
+        ParseArena _arena{};
         Packet _packet{};
+        SectionAssembler _section_assembler{};
+        ParseResult _dropped_section_result{};
+        size_t _packet_index{ 0 };
     };
+
+    using PacketParser = BasicPacketParser<TS_188_layout>;
 }
 
 #endif
@@ -1,18 +1,34 @@
 #ifndef __TS_PACKET_PROCESSOR_HPP__
 #define __TS_PACKET_PROCESSOR_HPP__
 
+#include "DemuxContext.hpp"
 #include "Packet.hpp"
+#include "PacketView.hpp"
+#include "ParseResult.hpp"
+#include "PES_Assembler.hpp"
 
 namespace TS
 {
     class PacketProcessor
     {
     public:
-        void process(const Packet& packet);
-        void process_PAT_payload(const Packet& packet);
-        void process_PMT_payload(const Packet& packet);
-        void process_PES_payload(const Packet& packet);
+        explicit PacketProcessor(DemuxContext& context) : _context{ context }, _PES_assembler{ context.PES_data } {}
+
+        // Return the first error found while updating the tables, or for a PES packet on a PID no PMT declares
+        ParseResult process(const Packet& packet);
+        ParseResult process(const PacketView& packet);  // only for PES packets: PSI packets need a fully parsed Packet
+        ParseResult process_PAT_payload(const Packet& packet);
+        ParseResult process_PMT_payload(const Packet& packet);
+        ParseResult process_PES_payload(const Packet& packet);
+        ParseResult process_PES_payload(const PacketView& packet);
     private:
+        // A packet may complete several sections
+        ParseResult process_PAT_section(const TableSyntax& ts);
+        ParseResult process_PMT_section(uint16_t PMT_PID, const TableSyntax& ts);
+        ParseResult process_PES_payload(uint16_t PES_PID, bool payload_unit_start_indicator, const byte_buffer_view& PES_data);
+
+        DemuxContext& _context;
+        PES_Assembler _PES_assembler;
     };
 }
 
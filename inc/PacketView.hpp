@@ -0,0 +1,67 @@
+#ifndef __TS_PACKET_VIEW_HPP__
+#define __TS_PACKET_VIEW_HPP__
+
+#include "ByteBufferView.hpp"
+#include "Packet.hpp"
+#include "ParseResult.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+
+namespace TS
+{
+    // Lightweight view over the raw bytes of a TS packet
+    //
+    // As opposed to Packet, which is populated eagerly by PacketParser, a packet view decodes fields on demand:
+    // - header fields are read straight from the header bytes,
+    // - adaptation field and PCR are only decoded when asked for, and
+    // - the payload offset is computed on first access, and cached.
+    // Most consumers (e.g. PES processing, stats) only need the PID and the payload,
+    // so for them the cost of parsing a packet reduces to those two accessors
+    //
+    class PacketView
+    {
+    public:
+        explicit PacketView(const byte_buffer_view& packet) : _packet{ packet } {}
+
+        // Header
+        [[nodiscard]] uint8_t get_sync_byte() const { return hdr_sync_byte_field.read(_packet); }
+        [[nodiscard]] bool get_transport_error_indicator() const { return hdr_transport_error_indicator_field.read(_packet); }
+        [[nodiscard]] bool get_payload_unit_start_indicator() const { return hdr_payload_unit_start_indicator_field.read(_packet); }
+        [[nodiscard]] bool get_transport_priority() const { return hdr_transport_priority_field.read(_packet); }
+        [[nodiscard]] uint16_t get_PID() const { return hdr_PID_field.read(_packet); }
+        [[nodiscard]] uint8_t get_transport_scrambling_control() const { return hdr_transport_scrambling_control_field.read(_packet); }
+        [[nodiscard]] uint8_t get_adaptation_field_control() const { return hdr_adaptation_field_control_field.read(_packet); }
+        [[nodiscard]] uint8_t get_continuity_counter() const { return hdr_continuity_counter_field.read(_packet); }
+
+        [[nodiscard]] bool has_adaptation_field() const;
+        [[nodiscard]] bool has_payload_data() const;
+
+        // Performs the same header checks as the parser (sync byte and transport error),
+        // and checks the adaptation field fits in the packet, so that the payload can be taken without further checks
+        ParseResult check_header() const;
+
+        // Adaptation field
+        [[nodiscard]] uint8_t get_adaptation_field_length() const;
+        [[nodiscard]] bool get_discontinuity_indicator() const;
+        [[nodiscard]] bool get_random_access_indicator() const;
+        [[nodiscard]] std::optional<ProgramClockReference> get_PCR() const;
+
+        // Payload
+        [[nodiscard]] uint8_t get_payload_offset() const;
+        [[nodiscard]] const byte_buffer_view get_payload() const;
+
+        [[nodiscard]] const byte_buffer_view get_bytes() const { return _packet; }
+
+        friend std::ostream& operator<<(std::ostream& os, const PacketView& view);
+
+    private:
+        [[nodiscard]] bool has_adaptation_field_flags() const;
+
+        byte_buffer_view _packet{};
+        mutable std::optional<uint8_t> _payload_offset{};
+    };
+}
+
+#endif
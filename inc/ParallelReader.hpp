@@ -0,0 +1,104 @@
+#ifndef __TS_PARALLEL_READER_HPP__
+#define __TS_PARALLEL_READER_HPP__
+
+#include "ByteBufferView.hpp"
+#include "ByteSource.hpp"
+#include "DemuxContext.hpp"
+#include "FileWriter.hpp"
+#include "PES_Assembler.hpp"
+#include "PID_Map.hpp"
+#include "WriterTable.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TS
+{
+    // Chunks are not made smaller than this, so that the seams between them are few compared to their packets
+    constexpr size_t min_parallel_chunk_size{ 1024 * 1024 };
+    // Size of the start of the file scanned for the PAT and PMT tables before splitting it into chunks
+    constexpr size_t parallel_PSI_scan_size{ 64 * 1024 * 1024 };
+
+    struct ParallelOptions
+    {
+        unsigned worker_count{ 0 };  // 0 means one per hardware thread
+    };
+
+    // Reads a memory-mapped TS file as N packet-aligned chunks, each one demuxed by its own worker thread
+    //
+    // PSI parsing is stateful, so the PAT and PMT tables of the demux context are first established by scanning the start of the file,
+    // until all of them are complete (or for at most parallel_PSI_scan_size bytes)
+    // That gives a frozen map of the PES PIDs to extract, along with the offset each one becomes known at,
+    // so that the packets a sequential read would drop for coming before their PMT are dropped too
+    // PSI updates later in the file are not taken into account
+    //
+    // Each worker has its own PES assembler, and writes its elementary stream data to a fragment file per PES PID
+    // (the first worker writes straight to the final output files)
+    // At the end of its chunk, a worker keeps reading the PIDs with a PES packet in progress, until each of them starts
+    // a new PES packet, while the next worker drops the payloads before the first PES packet start on each PID
+    // (as any PES assembler does), so every PES packet is written out exactly once
+    // Fragments are then appended, in chunk order, to the final output files
+    //
+    // Warnings give byte offsets instead of packet indices, since workers don't know how many packets come before them
+    // An error in any worker stops them all, and is rethrown by run()
+    //
+    template <typename Layout>
+    class BasicParallelReader
+    {
+    public:
+        BasicParallelReader(DemuxContext& context, const std::filesystem::path& file_path,
+            WriterTable& writers, const FileWriterOptions& writer_options,
+            const ParallelOptions& options);
+
+        void run();
+
+        [[nodiscard]] size_t get_skipped_bytes() const { return _skipped_bytes; }
+
+    private:
+        using PID = uint16_t;
+
+        struct PES_PID_Info
+        {
+            FileWriter* writer{ nullptr };  // final output file
+            size_t known_from{ 0 };  // offset of the first packet a sequential read would demux
+        };
+
+        struct Chunk
+        {
+            size_t begin{ 0 };
+            size_t end{ 0 };
+        };
+
+        // Scans the start of the file for the PAT and PMT tables, and fills in the map of PES PIDs to extract
+        void establish_PSI(const byte_buffer_view& file);
+        // Splits the file into chunks of about the same size, starting at packets in sync
+        [[nodiscard]] std::vector<Chunk> split(const byte_buffer_view& file) const;
+        void read_chunk(const byte_buffer_view& file, size_t chunk_index, const Chunk& chunk);
+        // Appends the fragments to the final output files, and removes them
+        void stitch(size_t chunk_count);
+        [[nodiscard]] std::filesystem::path get_fragment_path(PID pid, size_t chunk_index) const;
+        void warn(const std::string& message);
+        void fail(size_t chunk_index);
+
+        DemuxContext& _context;
+        std::filesystem::path _file_path{};
+        WriterTable& _writers;
+        FileWriterOptions _writer_options{};
+        ParallelOptions _options{};
+
+        PID_Map<PES_PID_Info> _PES_PIDs{};
+        std::atomic<size_t> _skipped_bytes{ 0 };
+        std::mutex _output_mutex{};
+        std::atomic<bool> _failed{ false };
+        std::vector<std::exception_ptr> _errors{};  // one per chunk
+    };
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef __TS_PARSE_ARENA_HPP__
+#define __TS_PARSE_ARENA_HPP__
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace TS
+{
+    // Default size of a parse arena
+    // It holds the products of the biggest packets: a reassembled section, plus the sections contained in the rest of the packet
+    constexpr size_t default_parse_arena_size{ 64 * 1024 };
+
+    // Monotonic arena backing the variable-sized products of parsing a packet (sections, PAT programs, ESSDs and descriptors)
+    //
+    // The block is allocated once, when the arena is created, and memory is handed out from it by bumping a pointer
+    // Nothing is given back until reset, which makes the whole block available again, so parsing packets doesn't touch the heap
+    // If a packet ever needs more than the block, the rest is taken from the heap, and given back on reset too
+    //
+    class ParseArena
+    {
+    public:
+        explicit ParseArena(size_t size = default_parse_arena_size)
+            : _block(size)
+            , _resource{ _block.data(), _block.size() }
+        {}
+
+        ParseArena(const ParseArena&) = delete;
+        ParseArena& operator=(const ParseArena&) = delete;
+
+        [[nodiscard]] std::pmr::memory_resource* get_resource() { return &_resource; }
+
+        // Everything allocated from the arena must not be referenced anymore
+        void reset() { _resource.release(); }
+
+    private:
+        std::vector<std::byte> _block{};
+        std::pmr::monotonic_buffer_resource _resource;
+    };
+}
+
+#endif
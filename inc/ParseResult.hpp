@@ -0,0 +1,87 @@
+#ifndef __TS_PARSE_RESULT_HPP__
+#define __TS_PARSE_RESULT_HPP__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+
+namespace TS
+{
+    // Errors found while parsing or processing a packet
+    enum class ParseError : uint8_t
+    {
+        Invalid_sync_byte,
+        Transport_error,
+        Invalid_adaptation_field_length,
+        Invalid_pointer_field,
+        Invalid_stuffing_bytes,
+        Invalid_section_syntax_indicator,
+        Invalid_private_bit,
+        Invalid_reserved_bits,
+        Invalid_unused_bits,
+        Invalid_section_length,
+        Dropped_section,
+        Invalid_CRC32,
+        Unknown_PES,
+        Duplicated_PMT_PID,
+        Duplicated_PES_PID,
+        Unknown_PMT_program_number,
+        Unimplemented_CAT_table,
+        Unimplemented_NIT_table,
+        Unimplemented_program_descriptors,
+        // Any error still thrown while parsing or processing a packet (e.g. a buffer overrun), and caught by the demuxer
+        Other
+    };
+    constexpr size_t parse_error_count{ static_cast<size_t>(ParseError::Other) + 1 };
+
+    // Same message as the exception of the error
+    [[nodiscard]] const char* get_message(ParseError error);
+    // Throws the exception of the error (see Exception.hpp)
+    [[noreturn]] void throw_parse_error(ParseError error);
+
+    // Result of parsing or processing (part of) a packet: nothing, or the error found, std::expected-style
+    // Errors are returned up to the demuxer instead of thrown, so that a bad packet doesn't cost much more than a good one
+    class [[nodiscard]] ParseResult
+    {
+    public:
+        ParseResult() = default;
+        ParseResult(ParseError error) : _error{ error } {}  // implicit, so that errors can just be returned
+
+        [[nodiscard]] bool has_value() const { return not _error; }
+        explicit operator bool() const { return not _error; }
+        [[nodiscard]] ParseError error() const { return *_error; }
+
+    private:
+        std::optional<ParseError> _error{};
+    };
+
+    // What the demuxer does with a packet it finds an error in
+    // Losses of sync are always handed back to the reader, which resynchronizes
+    enum class ErrorPolicy : uint8_t
+    {
+        abort,  // stop reading, with the error, the packet index and the packet (default)
+        skip,  // drop the packet, just counting the error
+        log,  // drop the packet, counting the error and printing a warning with the packet index
+        throw_exception  // throw the exception of the error straight from the demuxer, for callers catching them by type
+    };
+
+    // Number of packets dropped for every error
+    class ParseErrorCounts
+    {
+    public:
+        void count(ParseError error) { _counts[static_cast<size_t>(error)]++; _total++; }
+
+        [[nodiscard]] uint64_t get_count(ParseError error) const { return _counts[static_cast<size_t>(error)]; }
+        [[nodiscard]] uint64_t get_total() const { return _total; }
+
+        friend std::ostream& operator<<(std::ostream& os, const ParseErrorCounts& counts);
+
+    private:
+        std::array<uint64_t, parse_error_count> _counts{};
+        uint64_t _total{ 0 };
+    };
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef __TS_PIPE_SOURCE_HPP__
+#define __TS_PIPE_SOURCE_HPP__
+
+#include "ByteSource.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace TS
+{
+    // Reads the input from a pipe: standard input, or a named pipe (FIFO)
+    //
+    // Pipes can't be memory-mapped or read ahead, and a read returns what has been written to the pipe so far,
+    // so every window is completed with as many plain reads as needed, instead of waiting for whole blocks
+    // The buffer only grows up to the biggest window asked for, so memory stays bounded, whatever the length of the stream
+    //
+    class PipeSource : public ByteSource
+    {
+    public:
+        // Reads standard input
+        PipeSource();
+        // Reads a named pipe
+        explicit PipeSource(const std::filesystem::path& file_path);
+        ~PipeSource() override;
+
+        PipeSource(const PipeSource&) = delete;
+        PipeSource& operator=(const PipeSource&) = delete;
+
+        [[nodiscard]] byte_buffer_view fill(size_t n) override;
+        void consume(size_t n) override { _pos += n; }
+
+    private:
+        std::filesystem::path _file_path{};
+        int _fd{ -1 };
+        bool _owns_fd{ false };  // standard input is left open
+        bool _at_end{ false };
+        std::vector<uint8_t> _buffer{};
+        size_t _pos{ 0 };  // start of the window within the buffer
+        size_t _end{ 0 };  // end of the bytes read into the buffer
+    };
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef __TS_PIPELINE_HPP__
+#define __TS_PIPELINE_HPP__
+
+#include "ByteSource.hpp"
+#include "DemuxContext.hpp"
+#include "Demuxer.hpp"
+#include "FileWriter.hpp"
+#include "HeaderTable.hpp"
+#include "SPSC_Ring.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace TS
+{
+    constexpr size_t default_batch_packet_count{ 1024 };
+    // Number of packet batches going around the pipeline
+    // Queues can hold all of them, so the batches waiting to be refilled are what bounds the pipeline
+    constexpr size_t pipeline_batch_count{ 8 };
+
+    struct PipelineOptions
+    {
+        size_t batch_packet_count{ default_batch_packet_count };
+        std::optional<unsigned> first_cpu{};  // if set, stage i is pinned to CPU first_cpu + i
+    };
+
+    // Depth of a queue, sampled every time a batch is taken out of it
+    struct QueueDepth
+    {
+        size_t samples{ 0 };
+        size_t total{ 0 };
+        size_t max{ 0 };
+
+        void sample(size_t depth) { samples++; total += depth; max = std::max(max, depth); }
+        [[nodiscard]] double average() const { return samples ? static_cast<double>(total) / samples : 0.0; }
+    };
+
+    // Runs the reading of a TS file as a pipeline of four stages, each one on its own thread:
+    // - reader: reads batches of packets from the byte source, checking their sync bytes (and resynchronizing if needed),
+    // - parser: decodes the headers of the batch packets into a header table,
+    // - processor: demuxes the packets not dropped by their PID, and collects the elementary stream data to write out, and
+    // - writer: writes the elementary stream data out to the output files
+    //
+    // Stages are connected by lock-free SPSC queues of packet batches, and batches go back to the reader once written out
+    // PSI parsing is stateful (PES PIDs are only known once the PMT tables have been processed),
+    // so it stays in the processor stage, together with the PES processing
+    //
+    // An error in any stage stops the pipeline, and is rethrown by run()
+    // Warnings are printed to the demux context output stream
+    //
+    template <typename Layout>
+    class BasicPipeline
+    {
+    public:
+        BasicPipeline(DemuxContext& context, ByteSource& source, BasicDemuxer<Layout>& demuxer, const PipelineOptions& options);
+
+        void run();
+
+        [[nodiscard]] size_t get_skipped_bytes() const { return _skipped_bytes; }
+
+        template <typename L>
+        friend std::ostream& operator<<(std::ostream& os, const BasicPipeline<L>& pipeline);
+
+    private:
+        // Writes out the spans [first_span, first_span + span_count) of the batch
+        struct Output
+        {
+            FileWriter* writer{ nullptr };
+            size_t first_span{ 0 };
+            size_t span_count{ 0 };
+        };
+
+        struct Batch
+        {
+            std::vector<uint8_t> records{};  // stored packets (prefix + TS packet + suffix)
+            size_t count{ 0 };
+            HeaderTable headers{};
+            ES_gather_list spans{};  // views into the records
+            std::vector<Output> outputs{};
+            bool last{ false };  // no batches after this one
+        };
+
+        using Queue = SPSC_Ring<Batch*, pipeline_batch_count>;
+
+        void read_stage();
+        void parse_stage();
+        void process_stage();
+        void write_stage();
+
+        [[nodiscard]] Batch* pop(Queue& queue, QueueDepth& depth);
+        void fail();
+
+        DemuxContext& _context;
+        ByteSource& _source;
+        BasicDemuxer<Layout>& _demuxer;
+        PipelineOptions _options{};
+
+        std::array<Batch, pipeline_batch_count> _batches{};
+        Queue _free_batches{};
+        Queue _read_batches{};
+        Queue _parsed_batches{};
+        Queue _processed_batches{};
+        std::array<QueueDepth, 4> _queue_depths{};  // free, read, parsed, processed
+
+        size_t _skipped_bytes{ 0 };
+        std::atomic<bool> _failed{ false };
+        std::mutex _error_mutex{};
+        std::exception_ptr _error{};
+    };
+}
+
+#endif
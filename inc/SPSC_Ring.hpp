@@ -0,0 +1,92 @@
+#ifndef __TS_SPSC_RING_HPP__
+#define __TS_SPSC_RING_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace TS
+{
+    // Size of a cache line, so that producer and consumer indices don't share one
+    constexpr size_t cache_line_size{ 64 };
+
+    // Lock-free ring for exactly one producer thread and one consumer thread
+    //
+    // Indices only grow (they are masked when accessing the slots), the producer owning the tail and the consumer the head
+    // try_push/try_pop never block; push/pop wait (atomic wait, i.e. without spinning) for a free slot/an element,
+    // which gives back-pressure to the producer when the consumer falls behind
+    //
+    template <typename T, size_t Capacity>
+    class SPSC_Ring
+    {
+        static_assert(Capacity != 0 and (Capacity & (Capacity - 1)) == 0, "SPSC ring capacity must be a power of two");
+
+    public:
+        [[nodiscard]] bool try_push(const T& value)
+        {
+            const size_t tail{ _tail.load(std::memory_order_relaxed) };
+            if (tail - _head.load(std::memory_order_acquire) == Capacity)
+            {
+                return false;
+            }
+            _slots[tail & (Capacity - 1)] = value;
+            _tail.store(tail + 1, std::memory_order_release);
+            _tail.notify_one();
+            return true;
+        }
+
+        [[nodiscard]] std::optional<T> try_pop()
+        {
+            const size_t head{ _head.load(std::memory_order_relaxed) };
+            if (_tail.load(std::memory_order_acquire) == head)
+            {
+                return std::nullopt;
+            }
+            T value{ _slots[head & (Capacity - 1)] };
+            _head.store(head + 1, std::memory_order_release);
+            _head.notify_one();
+            return value;
+        }
+
+        void push(const T& value)
+        {
+            while (not try_push(value))
+            {
+                // Wait for the consumer to move the head
+                const size_t head{ _head.load(std::memory_order_acquire) };
+                if (_tail.load(std::memory_order_relaxed) - head == Capacity)
+                {
+                    _head.wait(head, std::memory_order_acquire);
+                }
+            }
+        }
+
+        [[nodiscard]] T pop()
+        {
+            for (;;)
+            {
+                if (auto value = try_pop())
+                {
+                    return *value;
+                }
+                // Wait for the producer to move the tail
+                const size_t head{ _head.load(std::memory_order_relaxed) };
+                _tail.wait(head, std::memory_order_acquire);
+            }
+        }
+
+        // Number of elements in the ring (only a snapshot when called from a third thread)
+        [[nodiscard]] size_t size() const
+        {
+            return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::array<T, Capacity> _slots{};
+        alignas(cache_line_size) std::atomic<size_t> _head{ 0 };
+        alignas(cache_line_size) std::atomic<size_t> _tail{ 0 };
+    };
+}
+
+#endif
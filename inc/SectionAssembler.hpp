@@ -0,0 +1,101 @@
+#ifndef __TS_SECTION_ASSEMBLER_HPP__
+#define __TS_SECTION_ASSEMBLER_HPP__
+
+#include "ByteBufferView.hpp"
+#include "Packet.hpp"
+#include "PID_Map.hpp"
+#include "ParseResult.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace TS
+{
+    // Maximum size of a PSI section: table header plus the maximum section length
+    constexpr size_t max_section_size{ table_header_size + th_max_section_length };
+
+    // Pool of section buffers, growing on demand
+    //
+    // Buffers are allocated in blocks, the first one when the pool is created, and the next ones only when every buffer is in use,
+    // so, once the pool has grown to the number of sections reassembled at the same time, reassembling sections doesn't touch the heap
+    // A PID reassembles one section at a time, plus the one it may have just completed,
+    // so the pool is bounded by the number of PIDs, however many programs the stream has
+    // If every buffer is in use anyway, acquire returns a null pointer, and the caller drops the section
+    //
+    class SectionBufferPool
+    {
+    public:
+        using buffer_type = std::array<uint8_t, max_section_size>;
+
+        static constexpr size_t buffer_block_size{ 32 };
+        static constexpr size_t max_buffer_count{ PID_count + buffer_block_size };
+
+        SectionBufferPool();
+
+        [[nodiscard]] buffer_type* acquire();
+        void release(buffer_type* buffer);
+
+        [[nodiscard]] size_t get_buffer_count() const { return _blocks.size() * buffer_block_size; }
+
+    private:
+        void grow();
+
+        std::vector<std::unique_ptr<buffer_type[]>> _blocks{};
+        std::vector<buffer_type*> _free_buffers{};
+    };
+
+    // Per PID reassembly of PSI sections spanning across several packets
+    //
+    // A section starts either right after the pointer field of a packet with the payload unit start indicator set,
+    // or right after the end of a previous section within the same packet
+    // When a section doesn't fit in the rest of the packet, its bytes are copied into a pooled buffer,
+    // and the payloads of the following packets on the same PID are appended to it until the section is complete
+    // A gap in the continuity counter drops the section being reassembled, while a repeated continuity counter
+    // (duplicated packet) is ignored
+    //
+    // Completed sections are returned as views over their buffers, which stay valid until release_completed is called
+    //
+    class SectionAssembler
+    {
+    public:
+        using PID = uint16_t;
+
+        [[nodiscard]] bool is_assembling(PID p) const { return _assemblies.contains(p) and _assemblies.at(p).buffer; }
+
+        // Starts reassembling a section from its first bytes (which may not even contain the whole table header)
+        // Returns an error if the section has to be dropped
+        ParseResult start(PID p, uint8_t continuity_counter, const byte_buffer_view& bytes);
+
+        // Appends the bytes of a packet to the section being reassembled for its PID, if any
+        // Sets the section if it is complete, and returns an error if its length is invalid,
+        // or if packets have been lost, and the section has to be dropped
+        ParseResult append(PID p, uint8_t continuity_counter, const byte_buffer_view& bytes, std::optional<byte_buffer_view>& section);
+
+        // Drops the section being reassembled for a PID, if any
+        void abort(PID p);
+
+        // Returns the buffers of completed sections to the pool
+        void release_completed();
+
+    private:
+        struct Assembly
+        {
+            SectionBufferPool::buffer_type* buffer{ nullptr };
+            size_t size{ 0 };
+            uint8_t continuity_counter{ 0 };
+        };
+
+        // Section size, if the table header has already been reassembled
+        [[nodiscard]] static std::optional<size_t> get_section_size(const Assembly& assembly);
+
+        SectionBufferPool _pool{};
+        PID_Map<Assembly> _assemblies{};  // a PID is not being reassembled if its assembly has no buffer
+        std::vector<SectionBufferPool::buffer_type*> _completed{};
+    };
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef __TS_SECTION_CACHE_HPP__
+#define __TS_SECTION_CACHE_HPP__
+
+#include "PID_Map.hpp"
+#include "PacketView.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace TS
+{
+    // Last version accepted of every PSI section, per PID
+    //
+    // PAT and PMT tables are repeated every few hundred milliseconds, almost always unchanged
+    // A packet carrying the same section as the last one accepted with its identity can skip parsing and processing altogether
+    // Sections are identified by their table id, table id extension and section number,
+    // so that the sections sharing a PID (e.g. a multi-section PAT, or several PMTs on the same PID) don't evict each other
+    // Entries are keyed on version number and CRC32 as well, which reject most changed sections without a comparison,
+    // and then the raw payload bytes are compared, so that a hit is exactly a repetition of an already accepted packet
+    //
+    class SectionCache
+    {
+    public:
+        using PID = uint16_t;
+
+        // Most sections remembered for a PID: once they are all in use, they are evicted in turn
+        static constexpr size_t max_sections_per_PID{ 16 };
+
+        // Returns true if the packet starts a section and its payload is the same as the last one accepted with its identity
+        // Only packets whose single section starts right after the pointer field and ends within the packet are cached
+        [[nodiscard]] bool contains(const PacketView& packet) const;
+
+        // Remembers the payload of a packet that has been successfully parsed and processed
+        void insert(const PacketView& packet);
+
+    private:
+        struct SectionKey
+        {
+            uint8_t table_id{ 0 };
+            uint16_t table_id_extension{ 0 };
+            uint8_t section_number{ 0 };
+            uint8_t version_number{ 0 };
+            uint32_t crc32{ 0 };
+
+            [[nodiscard]] bool is_same_section(const SectionKey& other) const
+            {
+                return table_id == other.table_id
+                    and table_id_extension == other.table_id_extension
+                    and section_number == other.section_number;
+            }
+
+            friend bool operator==(const SectionKey&, const SectionKey&) = default;
+        };
+
+        struct Entry
+        {
+            bool in_use{ false };
+            SectionKey key{};
+            uint8_t payload_size{ 0 };
+            std::array<uint8_t, packet_size - header_size> payload{};
+        };
+
+        struct PID_Entries
+        {
+            std::array<Entry, max_sections_per_PID> entries{};
+            size_t next_eviction{ 0 };
+        };
+
+        // Key of the single section starting at the beginning of the payload, if it fits in the packet
+        [[nodiscard]] static std::optional<SectionKey> get_section_key(const PacketView& packet);
+
+        PID_Map<PID_Entries> _entries{};
+    };
+}
+
+#endif
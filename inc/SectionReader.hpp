@@ -0,0 +1,47 @@
+#ifndef __TS_SECTION_READER_HPP__
+#define __TS_SECTION_READER_HPP__
+
+#include "ByteBufferView.hpp"
+#include "Exception.hpp"
+
+#include <cstddef>
+
+namespace TS
+{
+    // Section readers let the bytes of a PSI section be read in chunks, the same way packet buffers do for a packet
+    // They only hold a view over the section bytes, which can live:
+    // - within the packet buffer, for sections that fit in one packet (no copies are made), or
+    // - within a section buffer, for sections reassembled from several packets
+    //
+    class SectionReader
+    {
+    public:
+        explicit SectionReader(const byte_buffer_view& section) : _section{ section } {}
+
+        const byte_buffer_view read(size_t n)
+        {
+            const byte_buffer_view ret{ peek(n) };
+            _pos += n;
+            return ret;
+        }
+        const byte_buffer_view peek(size_t n) const  // reads without moving the read position
+        {
+            if (n > size_not_read())
+            {
+                throw SectionReaderOverrun(n, size_not_read());
+            }
+            return _section.subspan(_pos, n);
+        }
+
+        [[nodiscard]] const byte_buffer_view data() const { return _section; }
+        [[nodiscard]] size_t size() const { return _section.size(); }
+        [[nodiscard]] size_t size_not_read() const { return _section.size() - _pos; }
+        [[nodiscard]] size_t get_read_position() const { return _pos; }
+
+    private:
+        byte_buffer_view _section{};
+        size_t _pos{ 0 };
+    };
+}
+
+#endif
@@ -1,27 +1,83 @@
 #ifndef __TS_STATS_HPP__
 #define __TS_STATS_HPP__
 
+#include "ContinuityCounter.hpp"
 #include "Packet.hpp"
+#include "PacketView.hpp"
+#include "PSI_Tables.hpp"
 
-#include <set>
+#include <array>
+#include <cstdint>
+#include <optional>
 
 namespace TS
 {
+    // Consecutive PCRs further apart than this (1 second) are taken as a discontinuity, and not used for the bitrate
+    constexpr uint64_t max_PCR_interval{ 27'000'000 };
+
+    // Stats collect fixed-size counters per PID, so memory stays constant, whatever the size of the TS file:
+    // - packet count,
+    // - continuity counter errors (see ContinuityCounter), not checked for null packets,
+    // - scrambled packet count (transport scrambling control other than 0),
+    // - payload unit start count, and
+    // - PCR intervals (27 MHz ticks, and packets between consecutive PCRs), for PIDs carrying PCRs
+    //
+    // The TS bitrate is derived from the PCRs: packets (188 bytes) sent between them, over the time elapsed between them
+    // The bitrate of every PID is its share of the packets at the TS bitrate
+    //
     class Stats
     {
     public:
+        // Stream types are looked up in the PSI tables when printing
+        explicit Stats(const PSI_Tables& PSI_tables) : _PSI_tables{ PSI_tables } {}
         Stats(const Stats&) = delete;
         Stats(Stats&) = delete;
         Stats& operator=(const Stats&) = delete;
         Stats& operator=(Stats&&) = delete;
 
-        static Stats& get_instance();
         void collect(const Packet& packet);
+        void collect(const PacketView& packet);
+
+        // Bits per second, if there were at least two consecutive PCRs on a PID
+        [[nodiscard]] std::optional<uint64_t> get_TS_bitrate() const;
+
         friend std::ostream& operator<<(std::ostream& os, const Stats& stats);
     private:
-        Stats() {}
+        // Header fields the counters are updated from
+        struct PacketInfo
+        {
+            PID pid{ 0 };
+            bool payload_unit_start_indicator{ false };
+            uint8_t transport_scrambling_control{ 0 };
+            uint8_t continuity_counter{ 0 };
+            bool has_payload{ false };
+            bool discontinuity_indicator{ false };
+            std::optional<uint64_t> PCR{};  // 27 MHz units
+        };
+
+        struct PID_Stats
+        {
+            uint64_t packet_count{ 0 };
+            uint64_t CC_error_count{ 0 };
+            uint64_t scrambled_count{ 0 };
+            uint64_t PUSI_count{ 0 };
+
+            ContinuityCounter CC{};
+
+            uint64_t last_PCR{ 0 };
+            uint64_t last_PCR_packet_index{ 0 };
+            bool PCR_known{ false };
+        };
+
+        void collect(const PacketInfo& info);
+        void collect_PCR(PID_Stats& pid_stats, const PacketInfo& info);
 
-        std::multiset<uint16_t> _pids;
+        const PSI_Tables& _PSI_tables;
+        std::array<PID_Stats, PID_count> _PID_stats{};  // indexed by PID
+        uint64_t _packet_count{ 0 };
+        // Sums of the intervals between consecutive PCRs of every PID carrying them
+        uint64_t _PCR_ticks{ 0 };
+        uint64_t _PCR_packets{ 0 };
     };
 }
 
@@ -0,0 +1,45 @@
+#ifndef __TS_SYNC_SCANNER_HPP__
+#define __TS_SYNC_SCANNER_HPP__
+
+#include "ByteBufferView.hpp"
+#include "ByteSource.hpp"
+#include "Packet.hpp"
+#include "PacketLayout.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace TS
+{
+    // Number of consecutive packets that have to start with a sync byte for the stream to be considered in sync
+    constexpr uint8_t resync_packet_count{ 5 };
+    // Size of the input window scanned at a time when looking for the next sync position
+    constexpr size_t resync_window_size{ 1024 * 1024 };
+    // Number of consecutive packets that have to start with a sync byte for a packet stride to be detected
+    constexpr uint8_t probe_packet_count{ 8 };
+    // Size of the start of the input probed when detecting the packet stride
+    constexpr size_t probe_window_size{ 8 * 1024 };
+
+    // Finds the first offset in the buffer where the sync byte repeats at the packet stride for k consecutive packets
+    // The returned offset is the one of the sync byte, i.e. it is prefix_size bytes past the start of its stored packet
+    //
+    // Offsets too close to the end of the buffer to hold k packets are only considered if the buffer is the end of the input
+    // In that case, all the packets left (at least one) have to start with a sync byte, and the last one has to end the buffer
+    //
+    // Uses an AVX2 kernel (32 candidate offsets at a time) if the CPU supports it, and memchr otherwise
+    //
+    std::optional<size_t> find_sync_offset(const byte_buffer_view& buffer, size_t stride = packet_size,
+        size_t k = resync_packet_count, bool at_end = false, size_t prefix_size = 0);
+
+    // Detects the packet stride (188, 192 or 204 bytes) from the start of the input
+    // The stride whose packets are found in sync the earliest in the buffer wins
+    std::optional<uint8_t> detect_packet_stride(const byte_buffer_view& buffer, bool at_end);
+
+    // Looks for the next position where the sync byte repeats at the packet stride, and consumes the input up to there
+    // The packet that lost sync has to be at the current position of the source
+    // Returns the number of bytes skipped
+    size_t resynchronize(ByteSource& source, uint8_t stride, uint8_t prefix_size);
+}
+
+#endif
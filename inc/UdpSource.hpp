@@ -0,0 +1,81 @@
+#ifndef __TS_UDP_SOURCE_HPP__
+#define __TS_UDP_SOURCE_HPP__
+
+#include "ByteSource.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+    #define TS_HAS_UDP_SOURCE 1
+#else
+    #define TS_HAS_UDP_SOURCE 0
+#endif
+
+#if TS_HAS_UDP_SOURCE
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace TS
+{
+    // Biggest datagram received, bigger ones are truncated (7 packets of 204 bytes plus an RTP header fit in it)
+    constexpr size_t udp_max_datagram_size{ 2048 };
+    // Number of datagram slots, i.e. the most datagrams received by a single system call
+    constexpr size_t udp_slot_count{ 64 };
+    // Socket receive buffer asked for, so that bursts are not dropped while a block of packets is being demuxed
+    constexpr int udp_receive_buffer_size{ 8 * 1024 * 1024 };
+
+    // Reads the input from a UDP socket: udp://[<address>]:<port>, rtp://[<address>]:<port> being the same
+    //
+    // The socket is bound to the given IPv4 address (any address if none is given),
+    // and joins the group if the address is a multicast one (e.g. udp://239.1.1.1:1234)
+    //
+    // Datagrams are received in batches (recvmmsg) into a fixed set of slots, and their TS packets are appended to the window
+    // as it needs them, so memory stays constant, however long the stream is
+    // Datagrams carry either TS packets straight away (usually 7 of them),
+    // or an RTP header before them (RFC 2250), which is told by the first byte and stripped
+    //
+    // fill_available returns as soon as a batch of datagrams completes min_size bytes, instead of waiting for the whole window
+    // A live stream has no end: fill only returns a shorter window (the end of the input)
+    // if no datagram is received for the given idle timeout (0 waits forever)
+    //
+    class UdpSource : public ByteSource
+    {
+    public:
+        UdpSource(const std::string& url, uint64_t idle_timeout_ms);
+        ~UdpSource() override;
+
+        UdpSource(const UdpSource&) = delete;
+        UdpSource& operator=(const UdpSource&) = delete;
+
+        [[nodiscard]] byte_buffer_view fill(size_t n) override { return fill_available(n, n); }
+        [[nodiscard]] byte_buffer_view fill_available(size_t n, size_t min_size) override;
+        void consume(size_t n) override { _pos += n; }
+
+    private:
+        // Receives a batch of datagrams into the slots, waiting for the first one
+        // Returns false if none was received before the idle timeout
+        bool receive();
+        // TS packets of a datagram, without its RTP header, if it has one
+        [[nodiscard]] static byte_buffer_view get_TS_payload(const byte_buffer_view& datagram);
+
+        std::string _url{};
+        int _fd{ -1 };
+        std::vector<uint8_t> _slots{};  // udp_slot_count slots of udp_max_datagram_size bytes
+        std::array<iovec, udp_slot_count> _iovecs{};
+        std::array<mmsghdr, udp_slot_count> _headers{};
+        size_t _next_slot{ 0 };  // first datagram of the last batch not appended to the window yet
+        size_t _received_count{ 0 };  // datagrams in the last batch
+        bool _at_end{ false };
+        std::vector<uint8_t> _buffer{};
+        size_t _pos{ 0 };  // start of the window within the buffer
+        size_t _end{ 0 };  // end of the bytes appended to the buffer
+    };
+}
+
+#endif  // TS_HAS_UDP_SOURCE
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef __TS_URING_SOURCE_HPP__
+#define __TS_URING_SOURCE_HPP__
+
+#include "ByteSource.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    #define TS_HAS_IO_URING 1
+#else
+    #define TS_HAS_IO_URING 0
+#endif
+
+#if TS_HAS_IO_URING
+#include <sys/uio.h>
+
+namespace TS
+{
+    // Size of the blocks read by every io_uring request
+    constexpr size_t uring_block_size{ 4 * 1024 * 1024 };
+    // Windows can't be bigger than the headroom reserved in front of every block
+    constexpr size_t uring_max_window_size{ 1024 * 1024 };
+    // Number of block buffers: all of them but the one being parsed have a read in flight
+    constexpr size_t uring_block_count{ 4 };
+
+    // Reads the input with io_uring, keeping several block reads in flight while the previous block is being parsed
+    //
+    // Every buffer reserves some headroom before its data:
+    // when a window straddles two blocks, the bytes left in the first block are copied in front of the second one,
+    // so that windows are contiguous, and the first buffer can be given back to the ring straight away
+    //
+    // The ring is set up with the raw system calls, so no liburing is needed
+    // The constructor throws IoUringUnavailable if the kernel doesn't support (or doesn't allow) io_uring
+    //
+    class UringSource : public ByteSource
+    {
+    public:
+        explicit UringSource(const std::filesystem::path& file_path);
+        ~UringSource() override;
+
+        UringSource(const UringSource&) = delete;
+        UringSource& operator=(const UringSource&) = delete;
+
+        [[nodiscard]] byte_buffer_view fill(size_t n) override;
+        void consume(size_t n) override { _begin += n; }
+        [[nodiscard]] size_t get_max_window_size() const override { return uring_max_window_size; }
+
+    private:
+        struct Block
+        {
+            std::vector<uint8_t> buffer{};  // headroom + data
+            iovec io{};
+            size_t offset{ 0 };  // file offset of the data
+            size_t size{ 0 };  // bytes read so far
+            bool in_flight{ false };
+
+            [[nodiscard]] uint8_t* data() { return buffer.data() + uring_max_window_size; }
+        };
+
+        void setup_ring();
+        void close_ring();
+        void submit_read(size_t block_index);
+        void wait_for(size_t block_index);
+        void next_block();
+
+        std::filesystem::path _file_path{};
+        int _fd{ -1 };
+        size_t _file_size{ 0 };
+        size_t _next_read_offset{ 0 };
+        size_t _end_offset{ 0 };  // file offset of the end of the bytes read into the current block
+
+        std::array<Block, uring_block_count> _blocks{};
+        size_t _current{ 0 };
+        uint8_t* _begin{ nullptr };  // window start, within the current block (or its headroom)
+        uint8_t* _end{ nullptr };  // end of the bytes read into the current block
+
+        // Ring
+        int _ring_fd{ -1 };
+        void* _sq_ring{ nullptr };
+        size_t _sq_ring_size{ 0 };
+        void* _cq_ring{ nullptr };
+        size_t _cq_ring_size{ 0 };
+        void* _sqes{ nullptr };
+        size_t _sqes_size{ 0 };
+        unsigned* _sq_tail{ nullptr };
+        unsigned* _sq_mask{ nullptr };
+        unsigned* _sq_array{ nullptr };
+        unsigned* _cq_head{ nullptr };
+        unsigned* _cq_tail{ nullptr };
+        unsigned* _cq_mask{ nullptr };
+        void* _cqes{ nullptr };
+    };
+}
+#endif
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef __TS_WRITER_TABLE_HPP__
+#define __TS_WRITER_TABLE_HPP__
+
+#include "FileWriter.hpp"
+#include "Packet.hpp"
+#include "PSI_Tables.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TS
+{
+    // Output file of an elementary stream, named after its stream type, program and PID
+    // e.g. ts_stream_0x1b_program_1_PID_0x100.mp4
+    [[nodiscard]] std::filesystem::path get_output_file_path(stream_type st, program_number n, PID p, const std::string& file_name_prefix);
+
+    // PES PID -> file writer dispatch table
+    //
+    // There is one writer per elementary stream of the requested stream types, so that streams sharing a stream type
+    // (e.g. the audio tracks of a multi-program TS file) are written to different files
+    // Writers are created as the PMT tables declare their PIDs, and a packet is routed to its writer with a single lookup
+    //
+    class WriterTable
+    {
+    public:
+        WriterTable(const std::vector<uint8_t>& stream_type_list, const FileWriterOptions& options);
+
+        WriterTable(const WriterTable&) = delete;
+        WriterTable& operator=(const WriterTable&) = delete;
+
+        // Creates the writers of the PES PIDs the PSI tables have declared since the last update
+        // Returns true if any writer was created
+        bool update(const PSI_Tables& PSI_tables);
+
+        // Null if the PID has no writer
+        [[nodiscard]] FileWriter* get_writer(PID p) const { return _writers_by_PID[p]; }
+
+        // PIDs with a writer, in the order their writers were created
+        [[nodiscard]] const std::vector<PID>& get_PIDs() const { return _PIDs; }
+
+        // Flushes and closes all the writers, so that errors on the last writes are reported
+        void close();
+
+    private:
+        std::bitset<256> _stream_types{};
+        FileWriterOptions _options{};
+        std::array<FileWriter*, PID_count> _writers_by_PID{};
+        std::vector<std::unique_ptr<FileWriter>> _writers{};
+        std::vector<PID> _PIDs{};
+        size_t _known_PES_PID_count{ 0 };  // PES PIDs of the PSI tables already looked at
+    };
+}
+
+#endif
@@ -0,0 +1,77 @@
+#include "BatchReader.hpp"
+#include "DemuxContext.hpp"
+#include "Exception.hpp"
+#include "FileReader.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace TS
+{
+    BatchReader::BatchReader(
+        const std::vector<std::filesystem::path>& file_paths,
+        const FileReaderOptions& options,
+        const BatchOptions& batch_options)
+        : _file_paths{ file_paths }
+        , _options{ options }
+        , _batch_options{ batch_options }
+    {
+        if (_batch_options.job_count == 0)
+        {
+            _batch_options.job_count = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+    }
+
+    void BatchReader::start()
+    {
+        const size_t worker_count{ std::min<size_t>(_batch_options.job_count, _file_paths.size()) };
+        std::vector<std::thread> workers{};
+        for (size_t i{ 0 }; i < worker_count; ++i)
+        {
+            workers.emplace_back(&BatchReader::run_worker, this);
+        }
+        std::for_each(begin(workers), end(workers), [](std::thread& worker) { worker.join(); });
+
+        if (_failed_count != 0)
+        {
+            throw CouldNotReadTSFiles{ _failed_count, _file_paths.size() };
+        }
+    }
+
+    void BatchReader::run_worker()
+    {
+        // Workers take the next file not read yet, until there are none left
+        for (size_t i{ _next_file_index++ }; i < _file_paths.size(); i = _next_file_index++)
+        {
+            read_file(i);
+        }
+    }
+
+    void BatchReader::read_file(size_t file_index)
+    {
+        const std::filesystem::path& file_path{ _file_paths[file_index] };
+        std::ostringstream oss{};
+        try
+        {
+            DemuxContext context{ oss };
+            FileReaderOptions options{ _options };
+            // The stem alone is not unique, e.g. for files with the same name in different directories
+            options.writer_options.file_name_prefix = std::to_string(file_index + 1) + "_" + file_path.stem().string() + "_";
+
+            FileReader ts_reader{ context, file_path, options };
+            ts_reader.start();
+        }
+        catch (const std::exception& err)
+        {
+            oss << "Error: " << err.what() << "\n";
+            _failed_count++;
+        }
+
+        std::lock_guard<std::mutex> lock{ _output_mutex };
+        std::cout << file_path.string() << ":\n" << oss.str() << "\n";
+    }
+}
@@ -0,0 +1,90 @@
+#include "ByteSource.hpp"
+#include "Exception.hpp"
+#include "MappedFileSource.hpp"
+#include "PipeSource.hpp"
+#include "UdpSource.hpp"
+#include "UringSource.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <ostream>
+
+namespace TS
+{
+    StreamSource::StreamSource(const std::filesystem::path& file_path, size_t block_size)
+        : _block_size{ block_size }
+    {
+        // Blocks are read straight into our buffer, so the stream doesn't need a buffer of its own
+        _ifs.rdbuf()->pubsetbuf(nullptr, 0);
+        _ifs.open(file_path, std::fstream::binary);
+        if (!_ifs)
+        {
+            throw CouldNotOpenTSFile(file_path);
+        }
+    }
+
+    byte_buffer_view StreamSource::fill(size_t n)
+    {
+        if (_end - _pos < n and _ifs)
+        {
+            // Move the bytes not consumed yet to the front of the buffer,
+            // and read as many whole blocks as needed to complete the window after them
+            std::copy(begin(_buffer) + _pos, begin(_buffer) + _end, begin(_buffer));
+            _end -= _pos;
+            _pos = 0;
+            const size_t block_count{ (n - _end + _block_size - 1) / _block_size };
+            const size_t read_size{ block_count * _block_size };
+            if (_buffer.size() < _end + read_size)
+            {
+                _buffer.resize(_end + read_size);
+            }
+
+            _ifs.read(reinterpret_cast<char*>(_buffer.data() + _end), read_size);
+            _end += static_cast<size_t>(_ifs.gcount());
+        }
+        return { _buffer.data() + _pos, std::min(n, _end - _pos) };
+    }
+
+    std::unique_ptr<ByteSource> make_byte_source(const std::filesystem::path& file_path, InputMode input_mode,
+        [[maybe_unused]] std::ostream& out, [[maybe_unused]] uint64_t idle_timeout_ms)
+    {
+        if (is_stdin_input(file_path))
+        {
+            return std::make_unique<PipeSource>();
+        }
+        if (is_udp_input(file_path))
+        {
+#if TS_HAS_UDP_SOURCE
+            return std::make_unique<UdpSource>(file_path.string(), idle_timeout_ms);
+#else
+            throw UdpInputUnavailable{};
+#endif
+        }
+        // Named pipes and character devices can be neither memory-mapped nor read in aligned blocks
+        if (std::filesystem::exists(file_path) and not std::filesystem::is_regular_file(file_path))
+        {
+            return std::make_unique<PipeSource>(file_path);
+        }
+
+        switch (input_mode)
+        {
+        case InputMode::mmap: return std::make_unique<MappedFileSource>(file_path);
+        case InputMode::io_uring:
+#if TS_HAS_IO_URING
+            try
+            {
+                return std::make_unique<UringSource>(file_path);
+            }
+            catch (const IoUringUnavailable& err)
+            {
+                out << "Warning: " << err.what() << ", falling back to blocking reads\n";
+            }
+#else
+            out << "Warning: io_uring is not supported on this platform, falling back to blocking reads\n";
+#endif
+            return std::make_unique<StreamSource>(file_path);
+        default: return std::make_unique<StreamSource>(file_path);
+        }
+    }
+}
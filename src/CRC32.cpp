@@ -0,0 +1,192 @@
+#include "CpuFeatures.hpp"
+#include "CRC32.hpp"
+
+#include <array>
+#include <boost/crc.hpp>
+#include <cstring>
+
+#if defined(TS_X86)
+    #include <immintrin.h>
+#endif
+
+/*
+CRC32/MPEG-2 is not reflected: bytes are processed most significant bit first,
+and the CRC register holds the coefficient of x^31 in its most significant bit.
+
+Slicing-by-8
+------------
+tables[0][b] is the CRC of byte b (with a null initial value).
+tables[k][b] is the CRC of byte b followed by k null bytes.
+Every iteration XORs the CRC into the next 4 bytes of data, and looks up 8 bytes at once,
+each of them in the table corresponding to the number of bytes that follow it in the block.
+
+PCLMUL folding
+--------------
+Each 16-byte block is loaded byte-swapped, so that bit i of the 128-bit register is the coefficient of x^i.
+The initial value is XORed into the first 32 bits of the message (i.e. the top 32 bits of the first block).
+The message read so far, X, is kept congruent modulo P to a 128-bit value, and folded into the next block D:
+
+    X * x^128 + D = X_hi * x^192 + X_lo * x^128 + D = X_hi * (x^192 mod P) + X_lo * (x^128 mod P) + D   (mod P)
+
+Both products are 64 x 32-bit carry-less multiplications, so the result still fits in 128 bits.
+The main loop folds 4 blocks in parallel (with x^576 and x^512 constants), and the 4 accumulators are then folded into one.
+Finally, since X is congruent to the message, the CRC of the message is the CRC of the 16 bytes of X,
+which, together with any trailing bytes, is computed with the slicing-by-8 engine.
+*/
+
+namespace TS
+{
+    using crc_table = std::array<uint32_t, 256>;
+
+    constexpr std::array<crc_table, 8> make_slicing_by_8_tables()
+    {
+        std::array<crc_table, 8> tables{};
+        for (uint32_t b{ 0 }; b < 256; ++b)
+        {
+            uint32_t crc{ b << 24 };
+            for (int bit{ 0 }; bit < 8; ++bit)
+            {
+                crc = (crc & 0x8000'0000) ? (crc << 1) ^ crc32_mpeg2_polynomial : (crc << 1);
+            }
+            tables[0][b] = crc;
+        }
+        for (size_t k{ 1 }; k < 8; ++k)
+        {
+            for (size_t b{ 0 }; b < 256; ++b)
+            {
+                uint32_t prev{ tables[k - 1][b] };
+                tables[k][b] = (prev << 8) ^ tables[0][prev >> 24];
+            }
+        }
+        return tables;
+    }
+
+    constexpr std::array<crc_table, 8> slicing_by_8_tables{ make_slicing_by_8_tables() };
+
+    // x^n mod P
+    constexpr uint32_t x_pow_mod_P(size_t n)
+    {
+        uint32_t ret{ 1 };
+        for (size_t i{ 0 }; i < n; ++i)
+        {
+            ret = (ret & 0x8000'0000) ? (ret << 1) ^ crc32_mpeg2_polynomial : (ret << 1);
+        }
+        return ret;
+    }
+
+    uint32_t load_big_endian_32(const uint8_t* data)
+    {
+        return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16)
+            | (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+    }
+
+    uint32_t crc32_mpeg2_slicing_by_8(const uint8_t* data, size_t size, uint32_t crc)
+    {
+        const auto& t = slicing_by_8_tables;
+
+        for (; size >= 8; data += 8, size -= 8)
+        {
+            uint32_t one{ load_big_endian_32(data) ^ crc };
+            uint32_t two{ load_big_endian_32(data + 4) };
+            crc = t[7][one >> 24] ^ t[6][(one >> 16) & 0xff] ^ t[5][(one >> 8) & 0xff] ^ t[4][one & 0xff]
+                ^ t[3][two >> 24] ^ t[2][(two >> 16) & 0xff] ^ t[1][(two >> 8) & 0xff] ^ t[0][two & 0xff];
+        }
+        for (; size > 0; ++data, --size)
+        {
+            crc = (crc << 8) ^ t[0][(crc >> 24) ^ *data];
+        }
+        return crc;
+    }
+
+#if defined(TS_X86)
+    // Loads 16 bytes so that bit i of the register is the coefficient of x^i
+    TS_TARGET("pclmul,ssse3")
+    __m128i load_16_bytes(const uint8_t* data, __m128i byte_swap)
+    {
+        return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), byte_swap);
+    }
+
+    TS_TARGET("pclmul,ssse3")
+    __m128i fold_16_bytes(__m128i x, __m128i constants)
+    {
+        return _mm_xor_si128(_mm_clmulepi64_si128(x, constants, 0x11), _mm_clmulepi64_si128(x, constants, 0x00));
+    }
+
+    TS_TARGET("pclmul,ssse3")
+    uint32_t crc32_mpeg2_PCLMUL_impl(const uint8_t* data, size_t size, uint32_t crc)
+    {
+        if (size < 16)
+        {
+            return crc32_mpeg2_slicing_by_8(data, size, crc);
+        }
+
+        // Constants: high qword multiplies X_hi, low qword multiplies X_lo
+        const __m128i fold_by_1{ _mm_set_epi64x(x_pow_mod_P(192), x_pow_mod_P(128)) };
+        const __m128i fold_by_4{ _mm_set_epi64x(x_pow_mod_P(576), x_pow_mod_P(512)) };
+        const __m128i byte_swap{ _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15) };
+
+        __m128i x0{ _mm_xor_si128(load_16_bytes(data, byte_swap), _mm_set_epi32(static_cast<int>(crc), 0, 0, 0)) };
+        data += 16;
+        size -= 16;
+
+        if (size >= 48)
+        {
+            __m128i x1{ load_16_bytes(data, byte_swap) };
+            __m128i x2{ load_16_bytes(data + 16, byte_swap) };
+            __m128i x3{ load_16_bytes(data + 32, byte_swap) };
+            data += 48;
+            size -= 48;
+
+            for (; size >= 64; data += 64, size -= 64)
+            {
+                x0 = _mm_xor_si128(fold_16_bytes(x0, fold_by_4), load_16_bytes(data, byte_swap));
+                x1 = _mm_xor_si128(fold_16_bytes(x1, fold_by_4), load_16_bytes(data + 16, byte_swap));
+                x2 = _mm_xor_si128(fold_16_bytes(x2, fold_by_4), load_16_bytes(data + 32, byte_swap));
+                x3 = _mm_xor_si128(fold_16_bytes(x3, fold_by_4), load_16_bytes(data + 48, byte_swap));
+            }
+
+            x0 = _mm_xor_si128(fold_16_bytes(x0, fold_by_1), x1);
+            x0 = _mm_xor_si128(fold_16_bytes(x0, fold_by_1), x2);
+            x0 = _mm_xor_si128(fold_16_bytes(x0, fold_by_1), x3);
+        }
+
+        for (; size >= 16; data += 16, size -= 16)
+        {
+            x0 = _mm_xor_si128(fold_16_bytes(x0, fold_by_1), load_16_bytes(data, byte_swap));
+        }
+
+        // The CRC of the folded 16 bytes (with a null initial value) is the CRC of the message read so far
+        alignas(16) uint8_t folded[16]{};
+        _mm_store_si128(reinterpret_cast<__m128i*>(folded), _mm_shuffle_epi8(x0, byte_swap));
+        crc = crc32_mpeg2_slicing_by_8(folded, sizeof(folded), 0);
+
+        return crc32_mpeg2_slicing_by_8(data, size, crc);
+    }
+#endif
+
+    uint32_t crc32_mpeg2_PCLMUL(const uint8_t* data, size_t size, uint32_t crc)
+    {
+#if defined(TS_X86)
+        // The PCLMUL kernel would raise an illegal instruction on CPUs without PCLMUL (or SSE4.1, for the byte shuffles)
+        static const bool use_PCLMUL{ CpuFeatures::get_instance().has_PCLMUL() and CpuFeatures::get_instance().has_SSE4_1() };
+        if (use_PCLMUL)
+        {
+            return crc32_mpeg2_PCLMUL_impl(data, size, crc);
+        }
+#endif
+        return crc32_mpeg2_slicing_by_8(data, size, crc);
+    }
+
+    uint32_t crc32_mpeg2(const uint8_t* data, size_t size, uint32_t crc)
+    {
+        return crc32_mpeg2_PCLMUL(data, size, crc);
+    }
+
+    uint32_t crc32_mpeg2_reference(const uint8_t* data, size_t size)
+    {
+        using crc_32_mpeg2 = boost::crc_optimal<32, crc32_mpeg2_polynomial, crc32_mpeg2_initial_value, 0x00000000, false, false>;
+        crc_32_mpeg2 result{};
+        result.process_bytes(data, size);
+        return result.checksum();
+    }
+}
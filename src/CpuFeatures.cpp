@@ -0,0 +1,40 @@
+#include "CpuFeatures.hpp"
+
+#if defined(TS_X86) and defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace TS
+{
+    /* static */
+    const CpuFeatures& CpuFeatures::get_instance()
+    {
+        static CpuFeatures instance;
+        return instance;
+    }
+
+    CpuFeatures::CpuFeatures()
+    {
+#if defined(TS_X86) and defined(_MSC_VER)
+        int regs[4]{};
+        __cpuid(regs, 0);
+        int max_leaf{ regs[0] };
+
+        __cpuid(regs, 1);
+        _SSE4_1 = regs[2] & (1 << 19);
+        _PCLMUL = regs[2] & (1 << 1);
+        bool os_saves_ymm{ (regs[2] & (1 << 27)) and ((_xgetbv(0) & 0x6) == 0x6) };
+
+        if (max_leaf >= 7)
+        {
+            __cpuidex(regs, 7, 0);
+            _AVX2 = os_saves_ymm and (regs[1] & (1 << 5));
+        }
+#elif defined(TS_X86)
+        __builtin_cpu_init();
+        _SSE4_1 = __builtin_cpu_supports("sse4.1");
+        _AVX2 = __builtin_cpu_supports("avx2");
+        _PCLMUL = __builtin_cpu_supports("pclmul");
+#endif
+    }
+}
@@ -0,0 +1,216 @@
+#include "Demuxer.hpp"
+#include "Exception.hpp"
+#include "PacketView.hpp"
+
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace TS
+{
+    template <typename Layout>
+    BasicDemuxer<Layout>::BasicDemuxer(
+        DemuxContext& context,
+        const std::vector<uint8_t>& stream_type_list,
+        WriterTable& writers,
+        bool collect_stats,
+        Monitor* monitor,
+        ErrorPolicy error_policy)
+        : _context{ context }
+        , _parser{ context }
+        , _processor{ context }
+        , _filter{ stream_type_list, context.NIT_pid.get_NIT_PID() }
+        , _writers{ writers }
+        , _collect_stats{ collect_stats }
+        , _monitor{ monitor }
+        , _error_policy{ error_policy }
+    {}
+
+    template <typename Layout>
+    DemuxOutput BasicDemuxer<Layout>::demux(BasicPacketBuffer<Layout>& buffer)
+    {
+        PacketView view{ buffer.peek(packet_size) };
+        const size_t packet_index{ _parser.get_packet_index() };
+        _parsed = false;
+
+        DemuxOutput output{};
+        ParseResult result{};
+        std::string other_message{};
+        try
+        {
+            result = demux_packet(buffer, view, packet_index, output);
+        }
+        catch (const std::exception& err)
+        {
+            // Errors still thrown while parsing or processing (e.g. buffer overruns) go through the same policy
+            result = ParseError::Other;
+            other_message = err.what();
+        }
+
+        if (result)
+        {
+            return output;
+        }
+        return handle_error(result.error(), other_message.empty() ? get_message(result.error()) : other_message, view, packet_index);
+    }
+
+    template <typename Layout>
+    ParseResult BasicDemuxer<Layout>::demux_packet(BasicPacketBuffer<Layout>& buffer, const PacketView& view, size_t packet_index,
+        DemuxOutput& output)
+    {
+        // Drop packets we are not interested in just by looking at their PID
+        // Stats and the monitor need all the packets though
+        if (not _collect_stats
+            and not _monitor
+            and view.get_sync_byte() == sync_byte_valid_value
+            and not _filter.contains(view.get_PID()))
+        {
+            _parser.skip();
+            return {};
+        }
+
+        // The monitor reports transport errors itself
+        PID pid = view.get_PID();
+        if (_monitor and view.get_sync_byte() == sync_byte_valid_value and not _monitor->check(view, packet_index))
+        {
+            _parser.skip();
+            return {};
+        }
+
+        if (_context.PSI_tables.is_PES_PID(pid))
+        {
+            // PES packets don't need a full parse: just decode what is needed from the packet view
+            if (auto result{ view.check_header() }; not result)
+            {
+                return result;
+            }
+            _parser.skip();
+
+            // Process packet
+            if (auto result{ _processor.process(view) }; not result)
+            {
+                return result;
+            }
+            if (_monitor)
+            {
+                _monitor->check_PES(pid, packet_index);
+            }
+
+            // Collect stats
+            if (_collect_stats)
+            {
+                _context.stats.collect(view);
+            }
+
+            // Elementary stream data to write out to an output file
+            FileWriter* writer{ view.has_payload_data() ? _writers.get_writer(pid) : nullptr };
+            output = { writer, writer ? &_context.PES_data.get_ES_data(pid) : nullptr };
+            return {};
+        }
+
+        // PSI sections repeating the last version accepted of the same section have already been parsed and processed
+        if (auto result{ view.check_header() }; not result)
+        {
+            return result;
+        }
+        if (not _parser.is_assembling_section(pid) and _section_cache.contains(view))
+        {
+            _parser.skip();
+
+            // Collect stats
+            if (_collect_stats)
+            {
+                _context.stats.collect(view);
+            }
+            return {};
+        }
+
+        // Other packets (PSI) are fully parsed
+        _parsed = true;
+        if (auto result{ _parser.parse(buffer) }; not result)
+        {
+            return result;
+        }
+
+        // Process parsed packet
+        if (auto result{ _processor.process(_parser.get_packet()) }; not result)
+        {
+            return result;
+        }
+
+        // Update the PIDs we are interested in, and the writers of the elementary streams
+        if (_parser.get_packet().payload_contains_PSI())
+        {
+            _filter.add_table_PIDs(_parser.get_packet());
+            _writers.update(_context.PSI_tables);
+            if (not _parser.is_assembling_section(pid))
+            {
+                _section_cache.insert(view);
+            }
+        }
+
+        // Collect stats
+        if (_collect_stats)
+        {
+            _context.stats.collect(_parser.get_packet());
+        }
+
+        // A section started in a previous packet may have been dropped, even if this packet was demuxed
+        return _parser.get_dropped_section_result();
+    }
+
+    template <typename Layout>
+    DemuxOutput BasicDemuxer<Layout>::handle_error(ParseError error, std::string_view message, const PacketView& view, size_t packet_index)
+    {
+        // Lost sync: the caller decides how to resynchronize
+        if (error == ParseError::Invalid_sync_byte)
+        {
+            return { nullptr, nullptr, error };
+        }
+
+        // The packet is dropped, but still accounted for
+        if (_parser.get_packet_index() == packet_index)
+        {
+            _parser.skip();
+        }
+
+        // The monitor reports the error
+        if (_monitor)
+        {
+            _monitor->report_error(error, message, view.get_PID(), packet_index);
+            return {};
+        }
+
+        switch (_error_policy)
+        {
+        case ErrorPolicy::skip:
+            _context.parse_errors.count(error);
+            return {};
+        case ErrorPolicy::log:
+            _context.parse_errors.count(error);
+            _context.out << "Warning: " << message << "\n\tindex=" << packet_index << ", PID=0x" << std::hex << view.get_PID() << std::dec << "\n";
+            return {};
+        case ErrorPolicy::throw_exception:
+            if (error == ParseError::Other)
+            {
+                throw std::runtime_error{ std::string{ message } };
+            }
+            throw_parse_error(error);
+        default:
+        {
+            std::ostringstream oss{};
+            oss << message << "\n\tindex=" << packet_index << ", ";
+            if (_parsed) { oss << _parser.get_packet(); } else { oss << view; }
+            oss << "\n";
+            _error_message = oss.str();
+            return { nullptr, nullptr, error };
+        }
+        }
+    }
+
+    template class BasicDemuxer<TS_188_layout>;
+    template class BasicDemuxer<M2TS_192_layout>;
+    template class BasicDemuxer<TS_204_layout>;
+}
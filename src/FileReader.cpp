@@ -1,95 +1,161 @@
+#include "Demuxer.hpp"
 #include "Exception.hpp"
 #include "FileReader.hpp"
 #include "FileWriter.hpp"
 #include "PacketBuffer.hpp"
-#include "PacketParser.hpp"
-#include "PacketProcessor.hpp"
-#include "PES_Data.hpp"
-#include "PSI_Tables.hpp"
+#include "ParallelReader.hpp"
+#include "Pipeline.hpp"
+#include "SyncScanner.hpp"
+#include "WriterTable.hpp"
 
 #include <array>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace TS
 {
-    FileReader::FileReader(
-        const std::filesystem::path& file_path,
-        std::vector<uint8_t>&& stream_type_list,
-        bool collect_stats)
-        : _stream_type_list{ std::move(stream_type_list) }
-        , _collect_stats{ collect_stats }
+    FileReader::FileReader(DemuxContext& context, const std::filesystem::path& file_path, const FileReaderOptions& options)
+        : _context{ context }
+        , _file_path{ file_path }
+        , _source{ make_byte_source(file_path, options.input_mode, context.out, options.idle_timeout_ms) }
+        , _options{ options }
     {
-        _ifs.open(file_path, std::fstream::binary);
-        if (!_ifs)
+        if (_options.monitor_options)
         {
-            throw CouldNotOpenTSFile(file_path);
+            _monitor.emplace(_context, *_options.monitor_options);
         }
     }
 
-    FileReader::~FileReader()
+    void FileReader::start()
     {
-        _ifs.close();
+        // Writers are created as the PMT tables declare the elementary streams of the requested stream types
+        WriterTable writers{ _options.stream_type_list, _options.writer_options };
+
+        // Read packets with a parser specialized for the packet layout of the TS file
+        switch (detect_packet_stride())
+        {
+        case M2TS_192_layout::stride: read_packets<M2TS_192_layout>(writers); break;
+        case TS_204_layout::stride: read_packets<TS_204_layout>(writers); break;
+        default: read_packets<TS_188_layout>(writers); break;
+        }
+
+        // Flush the output files, so that errors on the last writes are reported
+        writers.close();
+
+        if (_skipped_bytes != 0)
+        {
+            _context.out << "Skipped " << _skipped_bytes << " bytes while resynchronizing\n";
+        }
+
+        // Packets dropped with the skip and log error policies
+        if (_context.parse_errors.get_total() != 0)
+        {
+            _context.out << _context.parse_errors;
+        }
+
+        // Print stats summary
+        if (_options.collect_stats)
+        {
+            _context.out << "\n" << _context.stats << "\n";
+        }
+
+        // Print monitor summary
+        if (_monitor)
+        {
+            _context.out << "\n" << *_monitor << "\n";
+        }
     }
 
-    void FileReader::start()
+    uint8_t FileReader::detect_packet_stride()
     {
-        // Initialize writers
-        std::vector<std::shared_ptr<FileWriter>> writers{};
-        std::for_each(cbegin(_stream_type_list), cend(_stream_type_list),
-            [&writers] (uint8_t st) {
-                writers.push_back(std::make_unique<FileWriter>(st));
-            });
+        const byte_buffer_view window{ _source->fill(probe_window_size) };
+        const bool at_end{ window.size() < probe_window_size };
 
-        // Read packets from TS stream loop
-        PacketParser parser{};
-        PacketProcessor processor{};
-        for (PacketBuffer buffer{}; _ifs >> buffer; )
+        // Default to plain TS if the stride couldn't be detected
+        return TS::detect_packet_stride(window, at_end).value_or(TS_188_layout::stride);
+    }
+
+    template <typename Layout>
+    void FileReader::read_packets(WriterTable& writers)
+    {
+        if (_options.parallel_options)
         {
-            try
-            {
-                // Parse packet
-                parser.parse(buffer);
+            BasicParallelReader<Layout> parallel_reader{ _context, _file_path, writers, _options.writer_options, *_options.parallel_options };
+            parallel_reader.run();
+            _skipped_bytes += parallel_reader.get_skipped_bytes();
+            return;
+        }
 
-                // Process parsed packet
-                processor.process(parser.get_packet());
+        // Read packets from TS stream loop
+        BasicDemuxer<Layout> demuxer{ _context, _options.stream_type_list, writers, _options.collect_stats, _monitor ? &*_monitor : nullptr,
+            _options.error_policy };
+        if (_options.pipeline_options)
+        {
+            BasicPipeline<Layout> pipeline{ _context, *_source, demuxer, *_options.pipeline_options };
+            pipeline.run();
+            _skipped_bytes += pipeline.get_skipped_bytes();
+            _context.out << pipeline;
+            return;
+        }
 
-                // Write streams to output files
-                PID pid = parser.get_packet().get_PID();
-                if (PES_Data::get_instance().has_PES_data(pid))
+        // Packets are read in blocks, and processed in place, within the block
+        // A packet straddling the end of a block is not consumed, so it is carried over to the start of the next one
+        // Live inputs return shorter blocks as soon as a packet is available
+        const size_t block_size{ block_packet_count * Layout::stride };
+        byte_buffer_view block{ _source->fill_available(block_size, Layout::stride) };
+        for (; block.size() >= Layout::stride; block = _source->fill_available(block_size, Layout::stride))
+        {
+            size_t block_consumed{ 0 };
+            for (; block.size() - block_consumed >= Layout::stride; block_consumed += Layout::stride)
+            {
+                BasicPacketBuffer<Layout> buffer{ block.subspan(block_consumed, Layout::stride) };
+                const DemuxOutput output{ demuxer.demux(buffer) };
+                if (not output.result and output.result.error() == ParseError::Invalid_sync_byte)
+                {
+                    // Lost sync: skip to the next position where the sync byte repeats at the packet stride
+                    // Resynchronization moves the input on its own, so the block is left for a new one
+                    // The monitor reports it as events, instead of a warning
+                    if (not _monitor)
+                    {
+                        _context.out << "Warning: " << InvalidSyncByte{}.what() << "\n\tindex=" << demuxer.get_packet_index() << "\n";
+                    }
+                    _source->consume(block_consumed);
+                    block_consumed = 0;
+                    auto skipped_bytes = resynchronize(*_source, Layout::stride, Layout::prefix_size);
+                    if (_monitor)
+                    {
+                        _monitor->report_sync_loss(demuxer.get_packet_index(), skipped_bytes, Layout::stride);
+                    }
+                    else
+                    {
+                        _context.out << "\tresynchronized after skipping " << skipped_bytes << " bytes\n";
+                    }
+                    _skipped_bytes += skipped_bytes;
+                    break;
+                }
+                if (not output.result)
                 {
-                    std::for_each(cbegin(writers), cend(writers),
-                        [&pid](std::shared_ptr<FileWriter> fw_sptr) {
-                            if (fw_sptr->get_stream_type() == PSI_Tables::get_instance().get_PES_stream_type(pid))
-                            {
-                                fw_sptr->write(PES_Data::get_instance().get_PES_data(pid));
-                            }
-                        });
+                    // Abort error policy
+                    throw std::runtime_error{ demuxer.get_error_message() };
                 }
 
-                // Collect stats
-                if (_collect_stats)
+                // Write elementary streams to output files
+                if (output.writer)
                 {
-                    Stats& stats = Stats::get_instance();
-                    stats.collect(parser.get_packet());
+                    output.writer->write(*output.ES_data);
                 }
             }
-            catch (const std::exception& err)
-            {
-                std::ostringstream oss{};
-                oss << err.what() << "\n\tindex=" << parser.get_packet_index() << ", " << parser.get_packet() << "\n";
-                throw std::runtime_error(oss.str().c_str());
-            }
+            _source->consume(block_consumed);
         }
 
-        // Print stats summary
-        if (_collect_stats)
+        // A file cut in the middle of a packet leaves a truncated packet at its end, which cannot be parsed
+        if (not block.empty())
         {
-            const Stats& stats = Stats::get_instance();
-            std::cout << "\n" << stats << "\n";
+            _context.out << "Warning: truncated packet at the end of the file"
+                << "\n\tindex=" << demuxer.get_packet_index() << ", size=" << block.size() << " bytes\n";
         }
     }
 
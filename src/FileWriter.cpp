@@ -1,32 +1,97 @@
+#include "Exception.hpp"
 #include "FileWriter.hpp"
 #include "StreamType.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <iomanip>
+#include <new>
+#include <numeric>
 #include <sstream>
+#include <vector>
+
+#if not defined(_WIN32)
+    #include <cerrno>
+    #include <climits>
+    #include <fcntl.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
 
 namespace TS
 {
-    std::filesystem::path get_new_output_stream_fp(stream_type t)
+    void FileWriter::AlignedDelete::operator()(uint8_t* p) const
     {
-        const char* file_stem{ "ts_stream_" };
-
-        std::ostringstream oss{ file_stem };
-        oss << file_stem << "0x" << std::hex << static_cast<uint16_t>(t) << '.' << StreamTypeMap::get_instance().get_file_extension(t);
-
-        return oss.str();
+        ::operator delete[](p, std::align_val_t{ write_alignment });
     }
 
-    FileWriter::FileWriter(stream_type st) noexcept
+    FileWriter::FileWriter(stream_type st, const std::filesystem::path& file_path, const FileWriterOptions& options)
         : _stream_type{ st }
+        , _file_path{ file_path }
     {
-        _ofs.open(get_new_output_stream_fp(_stream_type), std::ios_base::binary);
+        // Direct I/O writes whole buffers, so the buffer size has to be a multiple of the alignment
+        _buffer_size = std::max(options.buffer_size, write_alignment);
+        _buffer_size = (_buffer_size + write_alignment - 1) / write_alignment * write_alignment;
+        _async = options.async;
+        for (size_t i{ 0 }; i < (_async ? async_write_buffer_count : 1); ++i)
+        {
+            _buffers.emplace_back(static_cast<uint8_t*>(::operator new[](_buffer_size, std::align_val_t{ write_alignment })));
+        }
+
+#if defined(_WIN32)
+        _ofs.open(_file_path, std::ios_base::binary);
+        if (!_ofs)
+        {
+            throw CouldNotOpenOutputFile(_file_path);
+        }
+#else
+        const int flags{ O_WRONLY | O_CREAT | O_TRUNC };
+    #if defined(O_DIRECT)
+        // Not all file systems support direct I/O (e.g. tmpfs): just use buffered writes for those
+        if (options.direct_io)
+        {
+            _fd = open(_file_path.c_str(), flags | O_DIRECT, 0644);
+            _direct_io = _file_direct_io = (_fd != -1);
+        }
+    #endif
+        if (_fd == -1)
+        {
+            _fd = open(_file_path.c_str(), flags, 0644);
+        }
+        if (_fd == -1)
+        {
+            throw CouldNotOpenOutputFile(_file_path);
+        }
+
+    #if defined(__linux__)
+        // Preallocation is just a hint for the file system to lay the file out contiguously, so errors are ignored
+        // The file size is kept, so that it only grows with the data actually written
+        if (options.expected_size and *options.expected_size != 0)
+        {
+            [[maybe_unused]] int result{ fallocate(_fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(*options.expected_size)) };
+        }
+    #endif
+#endif
+
+        // The first buffer is filled straight away, while the others wait for their turn
+        _buffer = _buffers.front().get();
+        if (_async)
+        {
+            std::for_each(begin(_buffers) + 1, end(_buffers), [this](auto& buffer) { _free_buffers.push(buffer.get()); });
+            _writer_thread = std::thread{ &FileWriter::run_writer_thread, this };
+        }
     }
 
     FileWriter::~FileWriter()
     {
-        _ofs.close();
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
     }
 
     stream_type FileWriter::get_stream_type() const
@@ -36,9 +101,209 @@ namespace TS
 
     void FileWriter::write(const byte_buffer_view& data)
     {
-        if (_ofs)
+        if (_used + data.size() <= _buffer_size)
+        {
+            std::memcpy(_buffer + _used, data.data(), data.size());
+            _used += data.size();
+        }
+        else if (not _direct_io and not _async)
+        {
+            flush(std::span{ &data, 1 });
+        }
+        else
+        {
+            // Direct I/O only writes whole buffers, and the writer thread can't use the data after we return
+            for (byte_buffer_view rest{ data }; not rest.empty(); )
+            {
+                const size_t n{ std::min(rest.size(), _buffer_size - _used) };
+                std::memcpy(_buffer + _used, rest.data(), n);
+                _used += n;
+                rest = rest.subspan(n);
+                if (_used == _buffer_size)
+                {
+                    flush();
+                }
+            }
+        }
+    }
+
+    void FileWriter::write(std::span<const byte_buffer_view> data)
+    {
+        const size_t size{ std::accumulate(cbegin(data), cend(data), size_t{ 0 },
+            [](size_t total, const byte_buffer_view& span) { return total + span.size(); }) };
+
+        if (_used + size > _buffer_size and not _direct_io and not _async)
+        {
+            flush(data);
+            return;
+        }
+        std::for_each(cbegin(data), cend(data), [this](const byte_buffer_view& span) { write(span); });
+    }
+
+    void FileWriter::close()
+    {
+        if (_closed)
+        {
+            return;
+        }
+        _closed = true;
+
+        try
+        {
+            if (_async)
+            {
+                // Hand the last buffer over, and let the writer thread drain the ring
+                if (_used != 0)
+                {
+                    _full_chunks.push({ _buffer, _used });
+                    _used = 0;
+                }
+                _full_chunks.push({});
+                _writer_thread.join();
+                if (_writer_failed.load(std::memory_order_acquire))
+                {
+                    std::rethrow_exception(_writer_error);
+                }
+            }
+            else
+            {
+                flush();
+            }
+        }
+        catch (...)
+        {
+            close_file();
+            throw;
+        }
+        close_file();
+    }
+
+    void FileWriter::close_file()
+    {
+#if defined(_WIN32)
+        _ofs.close();
+        if (!_ofs)
+        {
+            throw CouldNotWriteOutputFile(_file_path);
+        }
+#else
+        if (::close(_fd) == -1)
+        {
+            throw CouldNotWriteOutputFile(_file_path);
+        }
+#endif
+    }
+
+    void FileWriter::flush(std::span<const byte_buffer_view> pending)
+    {
+        if (not _async)
         {
-            _ofs.write(reinterpret_cast<const char*>(&data[0]), data.size());
+            write_chunk({ _buffer, _used }, pending);
+            _used = 0;
+            return;
+        }
+
+        if (_writer_failed.load(std::memory_order_acquire))
+        {
+            std::rethrow_exception(_writer_error);
+        }
+        _full_chunks.push({ _buffer, _used });
+        _buffer = _free_buffers.pop();
+        _used = 0;
+    }
+
+    void FileWriter::write_chunk(const Chunk& chunk, std::span<const byte_buffer_view> pending)
+    {
+#if not defined(_WIN32)
+        // Only whole buffers can be written with direct I/O, so the last one is written through the page cache
+        if (_file_direct_io and chunk.size % write_alignment != 0)
+        {
+            fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) & ~O_DIRECT);
+            _file_direct_io = false;
+        }
+#endif
+        ES_gather_list spans{};
+        spans.reserve(pending.size() + 1);
+        spans.emplace_back(chunk.data, chunk.size);
+        spans.insert(end(spans), cbegin(pending), cend(pending));
+        write_spans(spans);
+    }
+
+    void FileWriter::run_writer_thread()
+    {
+        for (Chunk chunk{ _full_chunks.pop() }; chunk.data; chunk = _full_chunks.pop())
+        {
+            // After an error, buffers are just given back, so that the parser doesn't wait forever
+            if (not _writer_failed.load(std::memory_order_relaxed))
+            {
+                try
+                {
+                    write_chunk(chunk);
+                }
+                catch (...)
+                {
+                    _writer_error = std::current_exception();
+                    _writer_failed.store(true, std::memory_order_release);
+                }
+            }
+            _free_buffers.push(chunk.data);
+        }
+    }
+
+#if defined(_WIN32)
+    void FileWriter::write_spans(const ES_gather_list& spans)
+    {
+        for (const byte_buffer_view& span : spans)
+        {
+            _ofs.write(reinterpret_cast<const char*>(span.data()), span.size());
+        }
+        if (!_ofs)
+        {
+            throw CouldNotWriteOutputFile(_file_path);
+        }
+    }
+#else
+    void FileWriter::write_spans(const ES_gather_list& spans)
+    {
+        std::vector<iovec> iov{};
+        iov.reserve(spans.size());
+        for (const byte_buffer_view& span : spans)
+        {
+            if (not span.empty())
+            {
+                iov.push_back({ span.data(), span.size() });
+            }
+        }
+
+        // writev may write less than asked for: keep writing from where it stopped
+        for (size_t i{ 0 }; i < iov.size(); )
+        {
+            const int count{ static_cast<int>(std::min(iov.size() - i, size_t{ IOV_MAX })) };
+            const ssize_t written{ writev(_fd, &iov[i], count) };
+            if (written == -1 and errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                throw CouldNotWriteOutputFile(_file_path);
+            }
+
+            for (size_t n{ static_cast<size_t>(written) }; n != 0; )
+            {
+                if (n >= iov[i].iov_len)
+                {
+                    n -= iov[i].iov_len;
+                    ++i;
+                }
+                else
+                {
+                    iov[i].iov_base = static_cast<uint8_t*>(iov[i].iov_base) + n;
+                    iov[i].iov_len -= n;
+                    n = 0;
+                }
+            }
         }
     }
+#endif
 }
@@ -0,0 +1,220 @@
+#include "CpuFeatures.hpp"
+#include "HeaderTable.hpp"
+#include "Packet.hpp"
+
+#include <cstring>
+
+#if defined(TS_X86)
+    #include <immintrin.h>
+#endif
+
+/*
+The 4 header bytes of a packet are loaded as a little endian 32-bit word.
+That way, every header field is a shift and a mask away:
+
+    [header]       byte 0     byte 1     byte 2     byte 3
+                 ---------------------------------------------
+                 | ssssssss | teptPPPP | PPPPPPPP | ccaacccc |
+                 ---------------------------------------------
+
+    [word]       bits 0-7: sync byte                            bit 15: transport error indicator
+                 bit 14: payload unit start indicator           bits 8-12: PID (high bits)
+                 bits 16-23: PID (low bits)                     bits 30-31: transport scrambling control
+                 bits 28-29: adaptation field control           bits 24-27: continuity counter
+
+SIMD kernels load several headers into the lanes of a vector (AVX2 gathers them, SSE4.1 inserts them),
+decode all the fields lane-wise, and pack the 32-bit lanes down to the 16-bit or 8-bit output arrays.
+*/
+
+namespace TS
+{
+    void HeaderTable::resize(size_t n)
+    {
+        if (n > sync_byte.size())
+        {
+            sync_byte.resize(n);
+            transport_error_indicator.resize(n);
+            payload_unit_start_indicator.resize(n);
+            PID.resize(n);
+            transport_scrambling_control.resize(n);
+            adaptation_field_control.resize(n);
+            continuity_counter.resize(n);
+        }
+        _size = n;
+    }
+
+    bool HeaderTable::is_valid(size_t i) const
+    {
+        return sync_byte[i] == sync_byte_valid_value and not transport_error_indicator[i];
+    }
+
+    bool HeaderTable::has_adaptation_field(size_t i) const
+    {
+        return adaptation_field_control[i] == 2 || adaptation_field_control[i] == 3;
+    }
+
+    bool HeaderTable::has_payload_data(size_t i) const
+    {
+        return adaptation_field_control[i] == 1 || adaptation_field_control[i] == 3;
+    }
+
+    namespace
+    {
+        void decode_header_range(const uint8_t* data, size_t begin, size_t end, size_t stride, HeaderTable& table)
+        {
+            for (size_t i{ begin }; i < end; ++i)
+            {
+                const uint8_t* header{ data + i * stride };
+
+                table.sync_byte[i] = hdr_sync_byte_field.read(header);
+                table.transport_error_indicator[i] = hdr_transport_error_indicator_field.read(header);
+                table.payload_unit_start_indicator[i] = hdr_payload_unit_start_indicator_field.read(header);
+                table.PID[i] = hdr_PID_field.read(header);
+                table.transport_scrambling_control[i] = hdr_transport_scrambling_control_field.read(header);
+                table.adaptation_field_control[i] = hdr_adaptation_field_control_field.read(header);
+                table.continuity_counter[i] = hdr_continuity_counter_field.read(header);
+            }
+        }
+
+#if defined(TS_X86)
+        TS_TARGET("sse4.1")
+        void store_bytes_sse4_1(uint8_t* out, __m128i v)
+        {
+            __m128i tmp{ _mm_packus_epi32(v, v) };
+            tmp = _mm_packus_epi16(tmp, tmp);
+            int32_t bytes{ _mm_cvtsi128_si32(tmp) };
+            std::memcpy(out, &bytes, sizeof(bytes));
+        }
+
+        TS_TARGET("sse4.1")
+        size_t decode_header_vectors_sse4_1(const uint8_t* data, size_t count, size_t stride, HeaderTable& table)
+        {
+            const __m128i mask_1{ _mm_set1_epi32(0x1) };
+            const __m128i mask_2{ _mm_set1_epi32(0x3) };
+            const __m128i mask_4{ _mm_set1_epi32(0xf) };
+            const __m128i mask_8{ _mm_set1_epi32(0xff) };
+            const __m128i mask_PID_high{ _mm_set1_epi32(0x1f00) };
+
+            size_t i{ 0 };
+            for (; i + 4 <= count; i += 4)
+            {
+                int32_t words[4]{};
+                for (size_t j{ 0 }; j < 4; ++j)
+                {
+                    std::memcpy(&words[j], data + (i + j) * stride, sizeof(int32_t));
+                }
+                const __m128i w{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(words)) };
+
+                __m128i PID{ _mm_or_si128(_mm_and_si128(w, mask_PID_high), _mm_and_si128(_mm_srli_epi32(w, 16), mask_8)) };
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(&table.PID[i]), _mm_packus_epi32(PID, PID));
+
+                store_bytes_sse4_1(&table.sync_byte[i], _mm_and_si128(w, mask_8));
+                store_bytes_sse4_1(&table.transport_error_indicator[i], _mm_and_si128(_mm_srli_epi32(w, 15), mask_1));
+                store_bytes_sse4_1(&table.payload_unit_start_indicator[i], _mm_and_si128(_mm_srli_epi32(w, 14), mask_1));
+                store_bytes_sse4_1(&table.transport_scrambling_control[i], _mm_srli_epi32(w, 30));
+                store_bytes_sse4_1(&table.adaptation_field_control[i], _mm_and_si128(_mm_srli_epi32(w, 28), mask_2));
+                store_bytes_sse4_1(&table.continuity_counter[i], _mm_and_si128(_mm_srli_epi32(w, 24), mask_4));
+            }
+            return i;
+        }
+
+        TS_TARGET("avx2")
+        void store_bytes_avx2(uint8_t* out, __m256i v)
+        {
+            // Packing works within 128-bit lanes: bytes 0-3 end up in the low lane, and bytes 4-7 in the high one
+            __m256i tmp{ _mm256_packus_epi32(v, v) };
+            tmp = _mm256_packus_epi16(tmp, tmp);
+            __m128i bytes{ _mm_unpacklo_epi32(_mm256_castsi256_si128(tmp), _mm256_extracti128_si256(tmp, 1)) };
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+        }
+
+        TS_TARGET("avx2")
+        size_t decode_header_vectors_avx2(const uint8_t* data, size_t count, size_t stride, HeaderTable& table)
+        {
+            const __m256i offsets{ _mm256_mullo_epi32(
+                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride))) };
+            const __m256i mask_1{ _mm256_set1_epi32(0x1) };
+            const __m256i mask_2{ _mm256_set1_epi32(0x3) };
+            const __m256i mask_4{ _mm256_set1_epi32(0xf) };
+            const __m256i mask_8{ _mm256_set1_epi32(0xff) };
+            const __m256i mask_PID_high{ _mm256_set1_epi32(0x1f00) };
+
+            size_t i{ 0 };
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i w{ _mm256_i32gather_epi32(
+                    reinterpret_cast<const int*>(data + i * stride), offsets, 1) };
+
+                __m256i PID{ _mm256_or_si256(_mm256_and_si256(w, mask_PID_high), _mm256_and_si256(_mm256_srli_epi32(w, 16), mask_8)) };
+                PID = _mm256_permute4x64_epi64(_mm256_packus_epi32(PID, PID), 0b11'01'10'00);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&table.PID[i]), _mm256_castsi256_si128(PID));
+
+                store_bytes_avx2(&table.sync_byte[i], _mm256_and_si256(w, mask_8));
+                store_bytes_avx2(&table.transport_error_indicator[i], _mm256_and_si256(_mm256_srli_epi32(w, 15), mask_1));
+                store_bytes_avx2(&table.payload_unit_start_indicator[i], _mm256_and_si256(_mm256_srli_epi32(w, 14), mask_1));
+                store_bytes_avx2(&table.transport_scrambling_control[i], _mm256_srli_epi32(w, 30));
+                store_bytes_avx2(&table.adaptation_field_control[i], _mm256_and_si256(_mm256_srli_epi32(w, 28), mask_2));
+                store_bytes_avx2(&table.continuity_counter[i], _mm256_and_si256(_mm256_srli_epi32(w, 24), mask_4));
+            }
+            return i;
+        }
+#endif
+    }
+
+    void decode_headers_scalar(const byte_buffer_view& packets, HeaderTable& table, size_t stride, size_t prefix_size)
+    {
+        const size_t count{ packets.size() / stride };
+        table.resize(count);
+        decode_header_range(packets.data() + prefix_size, 0, count, stride, table);
+    }
+
+    void decode_headers_SSE4_1(const byte_buffer_view& packets, HeaderTable& table, size_t stride, size_t prefix_size)
+    {
+        const size_t count{ packets.size() / stride };
+        const uint8_t* headers{ packets.data() + prefix_size };
+        table.resize(count);
+
+        size_t decoded{ 0 };
+#if defined(TS_X86)
+        if (CpuFeatures::get_instance().has_SSE4_1())
+        {
+            decoded = decode_header_vectors_sse4_1(headers, count, stride, table);
+        }
+#endif
+        decode_header_range(headers, decoded, count, stride, table);
+    }
+
+    void decode_headers_AVX2(const byte_buffer_view& packets, HeaderTable& table, size_t stride, size_t prefix_size)
+    {
+        const size_t count{ packets.size() / stride };
+        const uint8_t* headers{ packets.data() + prefix_size };
+        table.resize(count);
+
+        size_t decoded{ 0 };
+#if defined(TS_X86)
+        if (CpuFeatures::get_instance().has_AVX2())
+        {
+            decoded = decode_header_vectors_avx2(headers, count, stride, table);
+        }
+#endif
+        decode_header_range(headers, decoded, count, stride, table);
+    }
+
+    void decode_headers(const byte_buffer_view& packets, HeaderTable& table, size_t stride, size_t prefix_size)
+    {
+#if defined(TS_X86)
+        const CpuFeatures& cpu{ CpuFeatures::get_instance() };
+        if (cpu.has_AVX2())
+        {
+            decode_headers_AVX2(packets, table, stride, prefix_size);
+            return;
+        }
+        if (cpu.has_SSE4_1())
+        {
+            decode_headers_SSE4_1(packets, table, stride, prefix_size);
+            return;
+        }
+#endif
+        decode_headers_scalar(packets, table, stride, prefix_size);
+    }
+}
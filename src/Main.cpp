@@ -1,3 +1,5 @@
+#include "BatchReader.hpp"
+#include "DemuxContext.hpp"
 #include "Exception.hpp"
 #include "FileReader.hpp"
 #include "StreamType.hpp"
@@ -7,6 +9,8 @@
 #include <exception>
 #include <filesystem>
 #include <iostream>
+#include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -18,19 +22,34 @@ using namespace TS;
 
 void print_usage()
 {
-    std::cout << "Usage: ts_reader <TS FILE PATH> [-e|--extract <STREAM TYPE LIST>] [-s|--stats]\n";
+    std::cout << "Usage: ts_reader <TS FILE PATH>... [-e|--extract <STREAM TYPE LIST>] [-s|--stats] [-m|--mmap|-u|--io-uring]\n";
+    std::cout << "                [-w|--write-buffer <MB>] [-d|--direct-io] [-a|--async-writers]\n";
+    std::cout << "                [-p|--pipeline] [-b|--batch-size <PACKETS>] [--pin-threads <FIRST CPU>]\n";
+    std::cout << "                [-j|--parallel [<WORKERS>]] [--jobs <FILES>] [--monitor [<PID TIMEOUT MS>]] [--idle-timeout <MS>]\n";
+    std::cout << "                [--error-policy abort|skip|log|throw]\n";
     std::cout << "\n";
     std::cout << "  E.g: ts_reader elephants.ts -e 0xf,0x1b\n";
     std::cout << "       ts_reader elephants.ts --stats\n";
+    std::cout << "       ts_reader elephants.ts -e 0xf,0x1b --mmap\n";
+    std::cout << "       ts_reader elephants.ts -e 0xf,0x1b --io-uring\n";
+    std::cout << "       ts_reader elephants.ts -e 0xf,0x1b --write-buffer 8 --direct-io\n";
+    std::cout << "       ts_reader elephants.ts -e 0xf,0x1b --async-writers\n";
+    std::cout << "       ts_reader elephants.ts -e 0xf,0x1b --pipeline --batch-size 2048 --pin-threads 0\n";
+    std::cout << "       ts_reader elephants.ts -e 0xf,0x1b --parallel 8\n";
+    std::cout << "       ts_reader elephants.ts bunny.ts -e 0xf,0x1b --stats --jobs 2\n";
+    std::cout << "       ts_reader elephants.ts --monitor 2000\n";
+    std::cout << "       ts_reader elephants.ts -e 0xf,0x1b --error-policy log\n";
+    std::cout << "       cat elephants.ts | ts_reader - -e 0xf,0x1b\n";
+    std::cout << "       ts_reader udp://239.1.1.1:1234 --monitor --idle-timeout 5000\n";
 }
 
 
 
 struct CommandLineValues
 {
-    std::filesystem::path ts_file_path{};
-    std::vector<uint8_t> stream_type_list{};
-    bool collect_stats{ false };
+    std::vector<std::filesystem::path> ts_file_paths{};
+    FileReaderOptions reader_options{};
+    BatchOptions batch_options{};
 };
 
 
@@ -39,18 +58,42 @@ CommandLineValues parse_command_line(int argc, char* argv[])
 {
     namespace po = boost::program_options;
 
-    std::filesystem::path ts_file_path{};
+    std::vector<std::filesystem::path> ts_file_paths{};
     std::string stream_type_list_str{};
     bool collect_stats{ false };
+    size_t write_buffer_size_mb{ default_write_buffer_size / (1024 * 1024) };
+    size_t batch_packet_count{ default_batch_packet_count };
+    unsigned first_cpu{ 0 };
+    unsigned worker_count{ 0 };
+    unsigned job_count{ 0 };
+    uint64_t PID_timeout_ms{ MonitorOptions{}.PID_timeout_ms };
+    uint64_t idle_timeout_ms{ 0 };
+    std::string error_policy_str{};
 
     po::positional_options_description pd;
     pd.add("ts-file-path", -1);
 
     po::options_description description{};
     description.add_options()
-        ("ts-file-path", po::value<std::filesystem::path>(&ts_file_path), "TS file path")
+        ("ts-file-path", po::value<std::vector<std::filesystem::path>>(&ts_file_paths), "TS file paths, - (standard input) or udp://[<address>]:<port>")
         ("extract,e", po::value<std::string>(&stream_type_list_str), "extract stream type to file")
         ("stats,s", "collect stats")
+        ("mmap,m", "memory-map the TS file instead of reading it")
+        ("io-uring,u", "read the TS file with io_uring, keeping several reads in flight (Linux only)")
+        ("write-buffer,w", po::value<size_t>(&write_buffer_size_mb), "size of the output file buffers in MB")
+        ("direct-io,d", "write output files bypassing the page cache")
+        ("async-writers,a", "write output files from background threads")
+        ("pipeline,p", "run reading, parsing, processing and writing on their own threads")
+        ("batch-size,b", po::value<size_t>(&batch_packet_count), "number of packets per pipeline batch")
+        ("pin-threads", po::value<unsigned>(&first_cpu), "pin the pipeline threads to consecutive CPUs, starting at this one")
+        ("parallel,j", po::value<unsigned>(&worker_count)->implicit_value(0),
+            "demux chunks of the TS file in parallel, with this number of workers (default: one per hardware thread)")
+        ("jobs", po::value<unsigned>(&job_count), "number of TS files read at the same time (default: one per hardware thread)")
+        ("monitor", po::value<uint64_t>(&PID_timeout_ms)->implicit_value(MonitorOptions{}.PID_timeout_ms),
+            "check TR 101 290 priority 1 and 2 indicators, reporting PIDs missing for this number of ms (default: 5000)")
+        ("idle-timeout", po::value<uint64_t>(&idle_timeout_ms), "end UDP inputs after this number of ms without datagrams (default: wait forever)")
+        ("error-policy", po::value<std::string>(&error_policy_str),
+            "what to do with packets that can't be demuxed: abort (default), skip, log, or throw their exception")
         ;
 
     po::variables_map vm;
@@ -64,15 +107,33 @@ CommandLineValues parse_command_line(int argc, char* argv[])
         throw UnrecognizedOption{ err.what() };
     }
 
-    // Parse TS file path
+    // Parse TS file paths
     //
     if (!vm.count("ts-file-path"))
     {
         throw InvalidNumberOfArguments{};
     }
-    if (!std::filesystem::exists(ts_file_path))
+    for (const std::filesystem::path& ts_file_path : ts_file_paths)
     {
-        throw TSFilePathNotFound{ ts_file_path };
+        // Standard input and UDP sockets are streamed, and not looked up in the file system
+        if (is_stdin_input(ts_file_path) or is_udp_input(ts_file_path))
+        {
+            continue;
+        }
+        if (!std::filesystem::exists(ts_file_path))
+        {
+            throw TSFilePathNotFound{ ts_file_path };
+        }
+    }
+    // An input can only be read once, whatever the way its path is written
+    std::set<std::filesystem::path> unique_ts_file_paths{};
+    for (const std::filesystem::path& ts_file_path : ts_file_paths)
+    {
+        const bool is_file{ not is_stdin_input(ts_file_path) and not is_udp_input(ts_file_path) };
+        if (not unique_ts_file_paths.insert(is_file ? std::filesystem::weakly_canonical(ts_file_path) : ts_file_path).second)
+        {
+            throw DuplicatedTSFilePath{ ts_file_path };
+        }
     }
 
     // Parse extract option
@@ -116,7 +177,100 @@ CommandLineValues parse_command_line(int argc, char* argv[])
     //
     collect_stats = vm.count("stats");
 
-    return { ts_file_path, stream_type_list, collect_stats };
+    // Parse mmap and io-uring options
+    //
+    if (vm.count("mmap") and vm.count("io-uring"))
+    {
+        throw ConflictingOptions{ "--mmap and --io-uring cannot be used together" };
+    }
+    InputMode input_mode{ InputMode::stream };
+    if (vm.count("mmap")) { input_mode = InputMode::mmap; }
+    if (vm.count("io-uring")) { input_mode = InputMode::io_uring; }
+
+    // Parse output file options
+    //
+    FileWriterOptions writer_options{};
+    writer_options.buffer_size = write_buffer_size_mb * 1024 * 1024;
+    writer_options.direct_io = vm.count("direct-io");
+    writer_options.async = vm.count("async-writers");
+
+    // Parse pipeline options
+    //
+    std::optional<PipelineOptions> pipeline_options{};
+    if (vm.count("pipeline"))
+    {
+        pipeline_options = PipelineOptions{};
+        pipeline_options->batch_packet_count = batch_packet_count;
+        if (vm.count("pin-threads"))
+        {
+            pipeline_options->first_cpu = first_cpu;
+        }
+    }
+
+    // Parse parallel options
+    //
+    std::optional<ParallelOptions> parallel_options{};
+    if (vm.count("parallel"))
+    {
+        // Stats and the pipeline are tied to a single sequential read of the file
+        if (collect_stats or pipeline_options)
+        {
+            throw ConflictingOptions{ "--parallel cannot be used together with --stats or --pipeline" };
+        }
+        // Chunks are memory-mapped, which needs regular files
+        if (not std::ranges::all_of(ts_file_paths, [](const auto& path) { return std::filesystem::is_regular_file(path); }))
+        {
+            throw ConflictingOptions{ "--parallel cannot be used with standard input, pipes or UDP inputs" };
+        }
+        parallel_options = ParallelOptions{ worker_count };
+    }
+
+    // Parse monitor options
+    //
+    std::optional<MonitorOptions> monitor_options{};
+    if (vm.count("monitor"))
+    {
+        // Events are reported in stream order, as they are found by a single sequential read of the file
+        if (pipeline_options or parallel_options)
+        {
+            throw ConflictingOptions{ "--monitor cannot be used together with --pipeline or --parallel" };
+        }
+        monitor_options = MonitorOptions{ PID_timeout_ms };
+    }
+
+    // Parse error policy option
+    //
+    ErrorPolicy error_policy{ ErrorPolicy::abort };
+    if (vm.count("error-policy"))
+    {
+        if (error_policy_str == "abort") { error_policy = ErrorPolicy::abort; }
+        else if (error_policy_str == "skip") { error_policy = ErrorPolicy::skip; }
+        else if (error_policy_str == "log") { error_policy = ErrorPolicy::log; }
+        else if (error_policy_str == "throw") { error_policy = ErrorPolicy::throw_exception; }
+        else { throw UnrecognizedOption{ ("invalid error policy: " + error_policy_str).c_str() }; }
+
+        // The monitor reports every error as an event, and parallel workers stop at the first error
+        if (monitor_options or parallel_options)
+        {
+            throw ConflictingOptions{ "--error-policy cannot be used together with --monitor or --parallel" };
+        }
+        // Warnings would be printed from both the reader and the processor threads
+        if (error_policy == ErrorPolicy::log and pipeline_options)
+        {
+            throw ConflictingOptions{ "--error-policy log cannot be used together with --pipeline" };
+        }
+    }
+
+    // Parse batch options
+    //
+    BatchOptions batch_options{};
+    batch_options.job_count = job_count;
+
+    return {
+        ts_file_paths,
+        { stream_type_list, collect_stats, input_mode, idle_timeout_ms, writer_options, pipeline_options, parallel_options, monitor_options, error_policy },
+        batch_options
+    };
 }
 
 
@@ -128,10 +282,20 @@ int main(int argc, char* argv[])
     {
         auto start = std::chrono::high_resolution_clock::now();
 
-        auto [ ts_file_path, stream_type_list, collect_stats ] = parse_command_line(argc, argv);
+        auto [ ts_file_paths, reader_options, batch_options ] = parse_command_line(argc, argv);
 
-        FileReader ts_reader{ ts_file_path, std::move(stream_type_list), collect_stats };
-        ts_reader.start();
+        if (ts_file_paths.size() == 1)
+        {
+            DemuxContext context{};
+            FileReader ts_reader{ context, ts_file_paths.front(), reader_options };
+            ts_reader.start();
+        }
+        else
+        {
+            // Several TS files are read concurrently, each one within its own demux context
+            BatchReader batch_reader{ ts_file_paths, reader_options, batch_options };
+            batch_reader.start();
+        }
         error = false;
 
         auto end = std::chrono::high_resolution_clock::now();
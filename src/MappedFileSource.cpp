@@ -0,0 +1,128 @@
+#include "Exception.hpp"
+#include "MappedFileSource.hpp"
+
+#include <algorithm>
+#include <filesystem>
+
+#if defined(_WIN32)
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace TS
+{
+#if defined(_WIN32)
+    MappedFileSource::MappedFileSource(const std::filesystem::path& file_path)
+    {
+        _file = CreateFileW(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        LARGE_INTEGER file_size{};
+        if (_file == INVALID_HANDLE_VALUE or not GetFileSizeEx(_file, &file_size))
+        {
+            if (_file != INVALID_HANDLE_VALUE) { CloseHandle(_file); }
+            throw CouldNotOpenTSFile(file_path);
+        }
+        _size = static_cast<size_t>(file_size.QuadPart);
+        if (_size == 0)
+        {
+            return;
+        }
+
+        _mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mapping)
+        {
+            _data = static_cast<uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (not _data)
+        {
+            if (_mapping) { CloseHandle(_mapping); }
+            CloseHandle(_file);
+            throw CouldNotOpenTSFile(file_path);
+        }
+    }
+
+    MappedFileSource::~MappedFileSource()
+    {
+        if (_data) { UnmapViewOfFile(_data); }
+        if (_mapping) { CloseHandle(_mapping); }
+        if (_file != INVALID_HANDLE_VALUE) { CloseHandle(_file); }
+    }
+
+    void MappedFileSource::advise(size_t)
+    {
+        // FILE_FLAG_SEQUENTIAL_SCAN already tells the cache manager about the access pattern
+    }
+#else
+    MappedFileSource::MappedFileSource(const std::filesystem::path& file_path)
+    {
+        _fd = open(file_path.c_str(), O_RDONLY);
+        struct stat file_stat{};
+        if (_fd == -1 or fstat(_fd, &file_stat) == -1)
+        {
+            if (_fd != -1) { close(_fd); }
+            throw CouldNotOpenTSFile(file_path);
+        }
+        _size = static_cast<size_t>(file_stat.st_size);
+        if (_size == 0)
+        {
+            return;
+        }
+
+        void* data{ mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0) };
+        if (data == MAP_FAILED)
+        {
+            close(_fd);
+            throw CouldNotOpenTSFile(file_path);
+        }
+        _data = static_cast<uint8_t*>(data);
+
+        madvise(_data, _size, MADV_SEQUENTIAL);
+        advise(0);
+    }
+
+    MappedFileSource::~MappedFileSource()
+    {
+        if (_data) { munmap(_data, _size); }
+        if (_fd != -1) { close(_fd); }
+    }
+
+    void MappedFileSource::advise(size_t pos)
+    {
+        // Prefetch the chunk following the current one
+        while (_prefetched_pos < std::min(_size, pos + 2 * mapped_chunk_size))
+        {
+            const size_t length{ std::min(mapped_chunk_size, _size - _prefetched_pos) };
+            madvise(_data + _prefetched_pos, length, MADV_WILLNEED);
+            _prefetched_pos += length;
+        }
+
+        // Release the chunks already consumed (chunk starts are page aligned)
+        while (_released_pos + mapped_chunk_size <= pos)
+        {
+            madvise(_data + _released_pos, mapped_chunk_size, MADV_DONTNEED);
+            _released_pos += mapped_chunk_size;
+        }
+    }
+#endif
+
+    byte_buffer_view MappedFileSource::fill(size_t n)
+    {
+        return { _data + _pos, std::min(n, _size - _pos) };
+    }
+
+    void MappedFileSource::consume(size_t n)
+    {
+        // Only look at the advice every chunk
+        const size_t previous_chunk{ _pos / mapped_chunk_size };
+        _pos += n;
+        if (_pos / mapped_chunk_size != previous_chunk)
+        {
+            advise(_pos);
+        }
+    }
+}
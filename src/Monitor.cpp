@@ -0,0 +1,339 @@
+#include "Exception.hpp"
+#include "Monitor.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace TS
+{
+    // PCR ticks in a millisecond
+    constexpr uint64_t PCR_ticks_per_ms{ PCR_frequency / 1000 };
+
+    // TR 101 290 number and name of every indicator
+    constexpr std::array<std::pair<const char*, const char*>, monitor_check_count> monitor_check_names{ {
+        { "1.1", "TS_sync_loss" },
+        { "1.2", "Sync_byte_error" },
+        { "1.3", "PAT_error" },
+        { "1.4", "Continuity_count_error" },
+        { "1.5", "PMT_error" },
+        { "1.6", "PID_error" },
+        { "2.1", "Transport_error" },
+        { "2.2", "CRC_error" },
+        { "2.3", "PCR_repetition_error" },
+        { "2.3", "PCR_discontinuity_indicator_error" },
+        { "2.5", "PTS_error" },
+        { "-", "Packet_error" }
+    } };
+
+    /* friend */
+    std::ostream& operator<<(std::ostream& os, const MonitorEvent& event)
+    {
+        const auto& [number, name] = monitor_check_names[static_cast<size_t>(event.check)];
+        os << "Event: " << number << " " << name << "\n\t";
+        if (event.time)
+        {
+            os << "time=" << std::fixed << std::setprecision(6) << *event.time << std::defaultfloat << " s, ";
+        }
+        os << "index=" << event.packet_index;
+        if (event.pid)
+        {
+            os << ", PID=0x" << std::hex << *event.pid << std::dec;
+        }
+        if (not event.details.empty())
+        {
+            os << ": " << event.details;
+        }
+        return os;
+    }
+
+    Monitor::Monitor(const DemuxContext& context, const MonitorOptions& options)
+        : _context{ context }
+        , _options{ options }
+    {}
+
+    bool Monitor::check(const PacketView& packet, size_t packet_index)
+    {
+        const PID p{ packet.get_PID() };
+        if (packet.get_transport_error_indicator())
+        {
+            report(MonitorCheck::Transport_error, packet_index, p, "transport error indicator set");
+            return false;
+        }
+
+        PID_State& state{ _states[p] };
+        state.last_seen = get_time(packet_index);
+        state.scrambled = packet.get_transport_scrambling_control() != 0;
+        const bool discontinuity_indicator{ packet.has_adaptation_field() and packet.get_discontinuity_indicator() };
+
+        if (p != null_PID)
+        {
+            const uint8_t last_CC{ state.CC.get_last() };
+            const uint8_t CC{ packet.get_continuity_counter() };
+            if (not state.CC.check(CC, packet.has_payload_data(), discontinuity_indicator))
+            {
+                std::ostringstream oss{};
+                oss << "CC " << static_cast<int>(CC) << " after " << static_cast<int>(last_CC);
+                report(MonitorCheck::Continuity_count_error, packet_index, p, oss.str());
+            }
+        }
+
+        const PSI_Tables& tables{ _context.PSI_tables };
+        if (p == PAT_PID or (tables.is_PMT_PID(p) and tables.get_PAT_program_number(p) != NIT_program_num))
+        {
+            check_PSI_section(state, p, packet, packet_index);
+        }
+
+        if (auto PCR{ packet.get_PCR() })
+        {
+            check_PCR(state, p, PCR->get_value(), discontinuity_indicator, packet_index);
+        }
+
+        if (_ticks_per_packet and packet_index >= _next_sweep_index)
+        {
+            sweep(packet_index);
+        }
+        return true;
+    }
+
+    void Monitor::check_PSI_section(PID_State& state, PID p, const PacketView& packet, size_t packet_index)
+    {
+        const MonitorCheck check{ p == PAT_PID ? MonitorCheck::PAT_error : MonitorCheck::PMT_error };
+        if (state.scrambled)
+        {
+            report(check, packet_index, p, "scrambled");
+            return;
+        }
+        if (not packet.get_payload_unit_start_indicator())
+        {
+            return;
+        }
+
+        // The first section starting in the packet is the one at the pointer field
+        const byte_buffer_view payload{ packet.get_payload() };
+        if (payload.empty() or 1u + payload[0] >= payload.size())
+        {
+            return;
+        }
+        const uint8_t table_id{ payload[1u + payload[0]] };
+
+        if (p == PAT_PID)
+        {
+            if (table_id == PAT_table_id)
+            {
+                _last_PAT = get_time(packet_index);
+            }
+            else if (table_id != stuffing_byte)
+            {
+                std::ostringstream oss{};
+                oss << "table id 0x" << std::hex << static_cast<int>(table_id);
+                report(check, packet_index, p, oss.str());
+            }
+        }
+        else if (table_id == PMT_table_id)
+        {
+            state.last_section = get_time(packet_index);
+        }
+    }
+
+    void Monitor::check_PCR(PID_State& state, PID p, uint64_t PCR, bool discontinuity_indicator, size_t packet_index)
+    {
+        if (state.last_PCR and not discontinuity_indicator)
+        {
+            // Going backwards shows up as a jump of almost a whole wrap around
+            const uint64_t ticks{ (PCR + PCR_wrap_around - *state.last_PCR) % PCR_wrap_around };
+            const uint64_t interval_ms{ ticks / PCR_ticks_per_ms };
+            if (interval_ms > max_PCR_discontinuity_ms)
+            {
+                std::ostringstream oss{};
+                oss << "PCR jumped by " << interval_ms << " ms without discontinuity indicator";
+                report(MonitorCheck::PCR_discontinuity_indicator_error, packet_index, p, oss.str());
+            }
+            else
+            {
+                if (interval_ms > max_PCR_repetition_ms)
+                {
+                    std::ostringstream oss{};
+                    oss << "PCR interval of " << interval_ms << " ms";
+                    report(MonitorCheck::PCR_repetition_error, packet_index, p, oss.str());
+                }
+
+                // Packet duration, for the stream time
+                if (ticks != 0 and packet_index > state.last_PCR_index)
+                {
+                    set_ticks_per_packet(static_cast<double>(ticks) / static_cast<double>(packet_index - state.last_PCR_index), packet_index);
+                }
+            }
+        }
+        state.last_PCR = PCR;
+        state.last_PCR_index = packet_index;
+    }
+
+    void Monitor::set_ticks_per_packet(double ticks_per_packet, size_t packet_index)
+    {
+        if (not _ticks_per_packet)
+        {
+            // Times kept so far are packet indices
+            auto to_time = [ticks_per_packet](std::optional<double>& time) {
+                if (time) { *time *= ticks_per_packet; }
+            };
+            std::for_each(begin(_states), end(_states), [&to_time](PID_State& state) {
+                to_time(state.last_seen);
+                to_time(state.last_section);
+                to_time(state.last_PTS_time);
+            });
+            to_time(_last_PAT);
+            _next_sweep_index = packet_index;
+            _clock_time = static_cast<double>(packet_index) * ticks_per_packet;
+        }
+        else
+        {
+            // The stream time goes on from the current packet, at the new packet duration
+            _clock_time = get_time(packet_index);
+        }
+        _clock_index = packet_index;
+        _ticks_per_packet = ticks_per_packet;
+        _sweep_packet_count = std::max<size_t>(1,
+            static_cast<size_t>(static_cast<double>(monitor_sweep_interval_ms * PCR_ticks_per_ms) / ticks_per_packet));
+    }
+
+    void Monitor::check_PES(PID p, size_t packet_index)
+    {
+        if (not _context.PES_data.has_PES_data(p))
+        {
+            return;
+        }
+        PID_State& state{ _states[p] };
+        const PES_Unit& unit{ _context.PES_data.get_PES_unit(p) };
+        if (unit.PTS and unit.PTS != state.last_PTS)
+        {
+            state.last_PTS = unit.PTS;
+            state.last_PTS_time = get_time(packet_index);
+        }
+    }
+
+    void Monitor::sweep(size_t packet_index)
+    {
+        _next_sweep_index = packet_index + _sweep_packet_count;
+        const PSI_Tables& tables{ _context.PSI_tables };
+        const double now{ get_time(packet_index) };
+
+        // PAT, from the start of the stream
+        if (uint64_t elapsed_ms{ get_elapsed_ms(_last_PAT.value_or(0), now) }; elapsed_ms > max_PAT_interval_ms)
+        {
+            report(MonitorCheck::PAT_error, packet_index, PAT_PID, "no PAT for " + std::to_string(elapsed_ms) + " ms");
+            _last_PAT = now;
+        }
+
+        // PMTs, from the moment the PAT declares them
+        const TPAT_map& PMT_program_numbers{ tables.get_PMT_program_numbers() };
+        const std::vector<PID>& PMT_PIDs{ PMT_program_numbers.get_PIDs() };
+        std::for_each(cbegin(PMT_PIDs) + _known_PMT_PID_count, cend(PMT_PIDs), [this, now](PID p) {
+            _states[p].last_section = _states[p].last_section.value_or(now);
+        });
+        _known_PMT_PID_count = PMT_PIDs.size();
+        for (PID p : PMT_PIDs)
+        {
+            PID_State& state{ _states[p] };
+            if (PMT_program_numbers.at(p) == NIT_program_num)
+            {
+                continue;
+            }
+            if (uint64_t elapsed_ms{ get_elapsed_ms(*state.last_section, now) }; elapsed_ms > max_PMT_interval_ms)
+            {
+                report(MonitorCheck::PMT_error, packet_index, p, "no PMT for " + std::to_string(elapsed_ms) + " ms");
+                state.last_section = now;
+            }
+        }
+
+        // Elementary stream PIDs, from the moment a PMT declares them
+        const std::vector<PID>& PES_PIDs{ tables.get_PES_stream_types().get_PIDs() };
+        std::for_each(cbegin(PES_PIDs) + _known_PES_PID_count, cend(PES_PIDs), [this, now](PID p) {
+            _states[p].last_seen = _states[p].last_seen.value_or(now);
+        });
+        _known_PES_PID_count = PES_PIDs.size();
+        for (PID p : PES_PIDs)
+        {
+            PID_State& state{ _states[p] };
+            if (uint64_t elapsed_ms{ get_elapsed_ms(*state.last_seen, now) }; elapsed_ms > _options.PID_timeout_ms)
+            {
+                report(MonitorCheck::PID_error, packet_index, p, "no packets for " + std::to_string(elapsed_ms) + " ms");
+                state.last_seen = now;
+            }
+            // PTSs can't be read from scrambled PES packets
+            if (state.last_PTS_time and not state.scrambled)
+            {
+                if (uint64_t elapsed_ms{ get_elapsed_ms(*state.last_PTS_time, now) }; elapsed_ms > max_PTS_interval_ms)
+                {
+                    report(MonitorCheck::PTS_error, packet_index, p, "no PTS for " + std::to_string(elapsed_ms) + " ms");
+                    state.last_PTS_time = now;
+                }
+            }
+        }
+    }
+
+    void Monitor::report_error(ParseError error, std::string_view message, PID p, size_t packet_index)
+    {
+        const PSI_Tables& tables{ _context.PSI_tables };
+        MonitorCheck check{ MonitorCheck::Packet_error };
+        if (error == ParseError::Invalid_CRC32)
+        {
+            check = MonitorCheck::CRC_error;
+        }
+        else if (error == ParseError::Transport_error)
+        {
+            check = MonitorCheck::Transport_error;
+        }
+        else if (p == PAT_PID)
+        {
+            check = MonitorCheck::PAT_error;
+        }
+        else if (tables.is_PMT_PID(p) and tables.get_PAT_program_number(p) != NIT_program_num)
+        {
+            check = MonitorCheck::PMT_error;
+        }
+        report(check, packet_index, p, std::string{ message });
+    }
+
+    void Monitor::report_sync_loss(size_t packet_index, size_t skipped_bytes, uint8_t stride)
+    {
+        report(MonitorCheck::Sync_byte_error, packet_index, std::nullopt, InvalidSyncByte{}.what());
+
+        // Skipping just the packet with the invalid sync byte means the next ones were still in sync
+        if (skipped_bytes > stride)
+        {
+            report(MonitorCheck::TS_sync_loss, packet_index, std::nullopt,
+                "resynchronized after skipping " + std::to_string(skipped_bytes) + " bytes");
+        }
+    }
+
+    void Monitor::report(MonitorCheck check, size_t packet_index, std::optional<PID> p, std::string details)
+    {
+        MonitorEvent event{ check, packet_index, std::nullopt, p, std::move(details) };
+        if (_ticks_per_packet)
+        {
+            event.time = get_time(packet_index) / static_cast<double>(PCR_frequency);
+        }
+        _event_counts[static_cast<size_t>(check)]++;
+        _context.out << event << "\n";
+    }
+
+    /* static */
+    uint64_t Monitor::get_elapsed_ms(double from, double to)
+    {
+        return static_cast<uint64_t>(std::max(to - from, 0.0) / static_cast<double>(PCR_ticks_per_ms));
+    }
+
+    /* friend */
+    std::ostream& operator<<(std::ostream& os, const Monitor& monitor)
+    {
+        os << "TR 101 290 events:\n";
+        for (size_t i{ 0 }; i < monitor_check_count; ++i)
+        {
+            const auto& [number, name] = monitor_check_names[i];
+            os << number << " " << name << "\tcount = " << monitor._event_counts[i] << "\n";
+        }
+        return os;
+    }
+}
@@ -0,0 +1,162 @@
+#include "Packet.hpp"
+#include "PES_Assembler.hpp"
+#include "PES_Data.hpp"
+
+#include <algorithm>
+
+namespace TS
+{
+    // Stream ids whose PES packets don't have an optional header (just data after the PES packet length)
+    bool has_optional_header(uint8_t stream_id)
+    {
+        return stream_id != program_stream_map_stream_id
+            and stream_id != padding_stream_id
+            and stream_id != private_stream_2_stream_id
+            and stream_id != ECM_stream_id
+            and stream_id != EMM_stream_id
+            and stream_id != DSMCC_stream_id
+            and stream_id != H222_1_type_E_stream_id
+            and stream_id != program_stream_directory_stream_id;
+    }
+
+    /* static */
+    size_t PES_Assembler::get_header_size(const State& state)
+    {
+        if (state.header_bytes < PES_header_size
+            or not has_optional_header(PES_stream_id_field.read(state.header.data())))
+        {
+            return PES_header_size;
+        }
+        if (state.header_bytes < PES_header_size + PES_optional_header_size)
+        {
+            return PES_header_size + PES_optional_header_size;
+        }
+        return PES_header_size + PES_optional_header_size
+            + PES_header_data_length_field.read(state.header.data() + PES_header_size);
+    }
+
+    /* static */
+    bool PES_Assembler::parse_header(State& state, PES_Unit& unit)
+    {
+        uint8_t* header{ state.header.data() };
+
+        if (PES_start_code_prefix_field.read(header) != PES_start_code_prefix)
+        {
+            return false;
+        }
+
+        unit.stream_id = PES_stream_id_field.read(header);
+        unit.PES_packet_length = PES_packet_length_field.read(header);
+        unit.PTS.reset();
+        unit.DTS.reset();
+
+        if (has_optional_header(unit.stream_id))
+        {
+            uint8_t* optional_header{ header + PES_header_size };
+            if (PES_marker_bits_field.read(optional_header) != PES_optional_header_marker_bits)
+            {
+                return false;
+            }
+
+            const uint8_t PTS_DTS_flags{ PES_PTS_DTS_flags_field.read(optional_header) };
+            const uint8_t header_data_length{ PES_header_data_length_field.read(optional_header) };
+            uint8_t* timestamps{ optional_header + PES_optional_header_size };
+            if (PTS_DTS_flags == PES_PTS_flag or PTS_DTS_flags == PES_PTS_DTS_flags)
+            {
+                if (header_data_length < PES_timestamp_size) { return false; }
+                unit.PTS = read_timestamp({ timestamps, PES_timestamp_size });
+            }
+            if (PTS_DTS_flags == PES_PTS_DTS_flags)
+            {
+                if (header_data_length < 2 * PES_timestamp_size) { return false; }
+                unit.DTS = read_timestamp({ timestamps + PES_timestamp_size, PES_timestamp_size });
+            }
+        }
+
+        // PES packet length counts the bytes following it
+        state.bytes_left.reset();
+        if (unit.PES_packet_length != 0)
+        {
+            const size_t header_bytes_counted{ state.header_bytes - PES_header_size };
+            if (unit.PES_packet_length < header_bytes_counted)
+            {
+                return false;
+            }
+            state.bytes_left = unit.PES_packet_length - header_bytes_counted;
+        }
+        return true;
+    }
+
+    void PES_Assembler::drop_unit(State& state)
+    {
+        state.in_unit = false;
+        _dropped_unit_count++;
+    }
+
+    bool PES_Assembler::is_in_unit(PID p) const
+    {
+        if (not _states.contains(p))
+        {
+            return false;
+        }
+        const State& state{ _states.at(p) };
+        return state.in_unit and state.bytes_left.value_or(1) != 0;
+    }
+
+    void PES_Assembler::assemble(PID p, bool payload_unit_start_indicator, const byte_buffer_view& payload)
+    {
+        State& state{ _states[p] };
+        PES_Unit& unit{ _PES_data.get_PES_unit(p) };
+        unit.ES_data.clear();
+
+        if (payload_unit_start_indicator)
+        {
+            state.in_unit = true;
+            state.header_complete = false;
+            state.header_bytes = 0;
+        }
+        if (not state.in_unit)
+        {
+            return;
+        }
+
+        byte_buffer_view bytes{ payload };
+
+        // Collect the header, whose size is only known as its fields are received
+        while (not state.header_complete)
+        {
+            const size_t header_size{ get_header_size(state) };
+            if (state.header_bytes == header_size)
+            {
+                state.header_complete = true;
+                if (not parse_header(state, unit))
+                {
+                    drop_unit(state);
+                    return;
+                }
+                break;
+            }
+            if (bytes.empty())
+            {
+                return;
+            }
+
+            const size_t n{ std::min(header_size - state.header_bytes, bytes.size()) };
+            std::copy_n(cbegin(bytes), n, begin(state.header) + state.header_bytes);
+            state.header_bytes += n;
+            bytes = bytes.subspan(n);
+        }
+
+        // Elementary stream bytes, up to the end of the PES packet if it is bounded
+        if (state.bytes_left)
+        {
+            const size_t n{ std::min(*state.bytes_left, bytes.size()) };
+            bytes = bytes.first(n);
+            *state.bytes_left -= n;
+        }
+        if (not bytes.empty() and unit.stream_id != padding_stream_id)
+        {
+            unit.ES_data.push_back(bytes);
+        }
+    }
+}
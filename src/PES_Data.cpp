@@ -2,25 +2,23 @@
 
 namespace TS
 {
-    /* static */
-    PES_Data& PES_Data::get_instance()
-    {
-        static PES_Data instance;
-        return instance;
-    }
-
     bool PES_Data::has_PES_data(PID p) const
     {
         return PES_map.contains(p);
     }
 
-    const byte_buffer_view PES_Data::get_PES_data(PID p) const
+    const PES_Unit& PES_Data::get_PES_unit(PID p) const
     {
         return PES_map.at(p);
     }
 
-    void PES_Data::set_PES_data(PID p, const byte_buffer_view& data)
+    PES_Unit& PES_Data::get_PES_unit(PID p)
+    {
+        return PES_map[p];
+    }
+
+    const ES_gather_list& PES_Data::get_ES_data(PID p) const
     {
-        PES_map[p] = data;
+        return PES_map.at(p).ES_data;
     }
 }
@@ -0,0 +1,57 @@
+#include "Packet.hpp"
+#include "PID_Filter.hpp"
+
+#include <algorithm>
+#include <variant>
+
+namespace TS
+{
+    PID_Filter::PID_Filter(const std::vector<stream_type>& stream_type_list, PID NIT_pid)
+        : _stream_type_list{ stream_type_list }
+    {
+        add(PAT_PID);
+        add(CAT_PID);
+        add(NIT_pid);
+    }
+
+    void PID_Filter::add_table_PIDs(const Packet& packet)
+    {
+        if (not packet.has_payload_data())
+        {
+            return;
+        }
+
+        std::for_each(cbegin(packet.payload_data->table_headers), cend(packet.payload_data->table_headers),
+            [this, &packet](const TableHeader& th) {
+                if (not th.table_syntax)
+                {
+                    return;
+                }
+
+                const auto& table_data = th.table_syntax->table_data;
+
+                if (packet.payload_contains_PAT_table())
+                {
+                    // PMT PIDs (and NIT PID, for program 0)
+                    const PAT_Table& patt = std::get<PAT_Table>(table_data);
+                    std::for_each(cbegin(patt.data), cend(patt.data), [this](const auto& program) {
+                        add(program.second);
+                    });
+                }
+                else if (packet.payload_contains_PMT_table())
+                {
+                    // Elementary stream PIDs of the requested stream types
+                    const PMT_Table& pmtt = std::get<PMT_Table>(table_data);
+                    if (pmtt.ESSD_info_data)
+                    {
+                        std::for_each(cbegin(*pmtt.ESSD_info_data), cend(*pmtt.ESSD_info_data), [this](const ESSD& essd) {
+                            if (std::find(cbegin(_stream_type_list), cend(_stream_type_list), essd.stream_type) != cend(_stream_type_list))
+                            {
+                                add(essd.elementary_PID);
+                            }
+                        });
+                    }
+                }
+            });
+    }
+}
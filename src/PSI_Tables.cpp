@@ -1,35 +1,27 @@
-#include "Exception.hpp"
+#include "Packet.hpp"
 #include "PSI_Tables.hpp"
 
 #include <algorithm>
 
 namespace TS
 {
-    bool PSI_Tables::PSI_Table::needs_update(uint8_t version)
+    bool PSI_Tables::PSI_Table::needs_update(uint8_t version, uint8_t section_number, uint8_t last_section_number)
     {
-        if (not _initialized)
+        if (not _initialized or version > _version)
         {
             _initialized = true;
             _version = version;
-
-            return true;
+            _last_section_number = last_section_number;
+            _sections.reset();
         }
 
-        if (version > _version)
+        if (version < _version or _sections[section_number])
         {
-            _version = version;
-
-            return true;
+            return false;
         }
 
-        return false;
-    }
-
-    /* static */
-    PSI_Tables& PSI_Tables::get_instance()
-    {
-        static PSI_Tables instance;
-        return instance;
+        _sections[section_number] = true;
+        return true;
     }
 
     program_number PSI_Tables::get_PAT_program_number(PID p) const
@@ -42,32 +34,40 @@ namespace TS
         return PES_stream_type_cache_table.at(p);
     }
 
-    void PSI_Tables::set_PAT_program_number(PID p, program_number n)
+    program_number PSI_Tables::get_PES_program_number(PID p) const
+    {
+        return PES_program_numbers.at(p);
+    }
+
+    ParseResult PSI_Tables::set_PAT_program_number(PID p, program_number n)
     {
         if (PAT_table.contains(p))
         {
-            throw Duplicated_PMT_PID{};
+            return ParseError::Duplicated_PMT_PID;
         }
         PAT_table[p] = n;
+        return {};
     }
 
-    void PSI_Tables::set_PMT_stream_type(program_number n, PID p, stream_type st)
+    ParseResult PSI_Tables::set_PMT_stream_type(program_number n, PID p, stream_type st)
     {
         if (PES_stream_type_cache_table.contains(p))
         {
-            throw Duplicated_PES_PID{};
+            return ParseError::Duplicated_PES_PID;
         }
 
         // Update PMT table
         if (not PMT_tables.contains(n))
         {
-            throw Unknown_PMT_Program_Number{};
+            return ParseError::Unknown_PMT_program_number;
         }
         PMT_Table& pmtt = PMT_tables[n];
         pmtt[p] = st;
 
         // Update PES stream type cache table
         PES_stream_type_cache_table[p] = st;
+        PES_program_numbers[p] = n;
+        return {};
     }
 
     bool PSI_Tables::is_PMT_PID(PID p) const
@@ -79,4 +79,23 @@ namespace TS
     {
         return PES_stream_type_cache_table.is_PES_PID(p);
     }
+
+    bool PSI_Tables::is_complete() const
+    {
+        if (not PAT_table.is_complete())
+        {
+            return false;
+        }
+        // The NIT PID is listed in the PAT too, as program 0, but it has no PMT
+        const TPAT_map& PAT_map{ PAT_table.get_map() };
+        return std::all_of(cbegin(PAT_map.get_PIDs()), cend(PAT_map.get_PIDs()), [this, &PAT_map](PID p) {
+            const program_number n{ PAT_map.at(p) };
+            if (n == NIT_program_num)
+            {
+                return true;
+            }
+            auto it = PMT_tables.find(n);
+            return it != cend(PMT_tables) and it->second.is_complete();
+        });
+    }
 }
@@ -1,5 +1,4 @@
 #include "Packet.hpp"
-#include "PSI_Tables.hpp"
 
 #include <iostream>
 
@@ -8,14 +7,7 @@ namespace TS
     // NIT PID is set to 0x10 by default
     // However, if PAT table associates program 0 with a different PID, we can update the NIT PID to that new value
 
-    /* static */
-    NIT_PID& NIT_PID::get_instance()
-    {
-        static NIT_PID instance;
-        return instance;
-    }
-
-    uint16_t NIT_PID::get_NIT_PID()
+    uint16_t NIT_PID::get_NIT_PID() const
     {
         return _value;
     }
@@ -27,6 +19,16 @@ namespace TS
 
 
 
+    // 33-bit timestamps are split in three chunks of 3, 15 and 15 bits, each of them followed by a marker bit
+    uint64_t read_timestamp(const byte_buffer_view& buffer)
+    {
+        return (static_cast<uint64_t>(aeo_DTS_next_access_unit_32_30_field.read(buffer)) << 30)
+            | (static_cast<uint64_t>(aeo_DTS_next_access_unit_29_15_field.read(buffer)) << 15)
+            | aeo_DTS_next_access_unit_14_0_field.read(buffer);
+    }
+
+
+
     /* friend */
     std::ostream& operator<<(std::ostream& os, const AdaptationExtension& ae)
     {
@@ -50,8 +52,8 @@ namespace TS
     {
         bool first{ true };
         os << "optional=(";
-        if (afo.PCR) { os << "PCR=<data>"; first = false; }
-        if (afo.OPCR) { os << (first ? "" : ", ") << "OPCR=<data>"; first = false; }
+        if (afo.PCR) { os << "PCR=" << afo.PCR->get_value(); first = false; }
+        if (afo.OPCR) { os << (first ? "" : ", ") << "OPCR=" << afo.OPCR->get_value(); first = false; }
         if (afo.splice_countdown)
         {
             os << (first ? "" : ", ") << "SC=" << static_cast<int16_t>(*afo.splice_countdown);
@@ -108,11 +110,15 @@ namespace TS
     std::ostream& operator<<(std::ostream& os, const PayloadData& pd)
     {
         os << "payload={";
-        if (!pd.pointer and !pd.table_header) { os << "<data>"; }
+        if (!pd.pointer and pd.table_headers.empty()) { os << "<data>"; }
         else
         {
             if (pd.pointer) { os << *pd.pointer; }
-            if (pd.table_header) { os << (pd.pointer ? ", " : "") << *pd.table_header; }
+            for (bool first{ !pd.pointer }; const TableHeader& th : pd.table_headers)
+            {
+                os << (first ? "" : ", ") << th;
+                first = false;
+            }
         }
         os << "}";
         return os;
@@ -137,8 +143,9 @@ namespace TS
     std::ostream& operator<<(std::ostream& os, const Packet& packet)
     {
         os << "packet=[" << packet.header;
-        if (packet.has_adaptation_field()) { os << ", " << *packet.adaptation_field; }
-        if (packet.has_payload_data()) { os << ", " << *packet.payload_data; }
+        // A packet with errors may not have been parsed up to its adaptation field or payload data
+        if (packet.has_adaptation_field() and packet.adaptation_field) { os << ", " << *packet.adaptation_field; }
+        if (packet.has_payload_data() and packet.payload_data) { os << ", " << *packet.payload_data; }
         os << "]";
         return os;
     }
@@ -168,8 +175,8 @@ namespace TS
 
     bool Packet::payload_contains_PAT_table() const { return header.PID == PAT_PID; }
     bool Packet::payload_contains_CAT_table() const { return header.PID == CAT_PID; }
-    bool Packet::payload_contains_NIT_table() const { return header.PID == NIT_PID::get_instance().get_NIT_PID(); }
-    bool Packet::payload_contains_PMT_table() const { return PSI_Tables::get_instance().is_PMT_PID(header.PID); }
+    bool Packet::payload_contains_NIT_table() const { return carries_NIT; }
+    bool Packet::payload_contains_PMT_table() const { return carries_PMT; }
     bool Packet::payload_contains_PSI() const
     {
         return payload_contains_PAT_table()
@@ -1,128 +1,114 @@
-#include "Exception.hpp"
+#include "CRC32.hpp"
 #include "Packet.hpp"
 #include "PacketParser.hpp"
-#include "PSI_Tables.hpp"
+#include "SectionReader.hpp"
 
 #include <algorithm>
-#include <boost/crc.hpp>
-#include <boost/dynamic_bitset/dynamic_bitset.hpp>
-#include <boost/endian/conversion.hpp>
 #include <iostream>
 #include <iterator>
-
-using namespace boost::endian;
+#include <type_traits>
 
 /*
 TS headers are encoded as Big Endian (most significative byte in lowest memory address).
 TS payloads are written out in the same byte order as they are read.
 
-To parse a field from the TS file                     [table header file block]          2    1    0        (index)
-(e.g. table header's section length):                                                  <---------------
-                                                                                       | 0d | b0 | 00 |     (value)
-                                                                                       <---------------
-
-1) Read the TS packet into a byte buffer.             [table header buffer]              2    1    0
-2) Create the bitset from the buffer.                 [table header bitset]            <---------------
-                                                                                       | 0d | b0 | 00 |
-                                                                                       <---------------
-
-3) Bitwise-and the bitset with the mask bitset        [section length mask bitset]       2    1    0
-   into a temporary.                                                                   <---------------
-                                                                                       | ff | 03 | 00 |
-                                                                                       <---------------
-
-                                                      [tmp bitset]                       2    1    0
-                                                                                       <---------------
-                                                                                       | 0d | 00 | 00 |
-                                                                                       <---------------
-
-4) Right shift the temporary bitset so that           [tmp bitset]                       2    1    0
-   the masked value is at the lowest position.                                         <---------------
-                                                                                       | 00 | 0d | 00 |
-                                                                                       <---------------
-
-5) Convert the value to ulong.                        [ulong]                          0x00'00'0d'00
-6) Cast it to the return type.                        [uint32_t]                       0x00'00'0d'00  // Big Endian
-7) Convert the value from Big Endian to native.       [uint32_t]                       0x00'00'00'0d  // Native
-*/
+To parse a field from the TS file                     [table header file block]          0    1    2        (index)
+(e.g. table header's section length):                                                  --------------->
+                                                                                       | 00 | b0 | 0d |     (value)
+                                                                                       --------------->
 
-namespace TS
-{
-    /* static */
-    size_t PacketParser::_packet_index{ 0 };
+1) Read the chunk of bytes containing the field       [table header buffer]              0    1    2
+   from the packet buffer.                                                             --------------->
+                                                                                       | 00 | b0 | 0d |
+                                                                                       --------------->
 
-    template <uint8_t buffer_size>
-    auto from_packet_buffer(PacketBuffer& p_buffer)
-    {
-        // Read from packet buffer into byte buffer
-        auto buffer = p_buffer.read(buffer_size);
+2) Load the bytes the field spans over,               [section length bit field]       byte offset = 1
+   as described by its bit field, into an integer.                                     bit shift = 0
+                                                                                       bit width = 10
 
-        // Create bitset from buffer
-        boost::dynamic_bitset<uint8_t> ret_bs{ buffer_size * 8 };
-        from_block_range(cbegin(buffer), cend(buffer), ret_bs);
+                                                      [uint64_t]                       0x00'00'b0'0d
 
-        return ret_bs;
-    }
+3) Right shift the integer by the bit shift,          [uint64_t]                       0x00'00'00'0d
+   and mask it with the bit width.
 
-    template <typename ReturnType>
-    ReturnType read_field(const boost::dynamic_bitset<uint8_t>& bs, const boost::dynamic_bitset<uint8_t>& mask_bs)
-    {
-        auto tmp_bs{ bs & mask_bs };
-        tmp_bs >>= mask_bs.find_first();
-        return big_to_native(static_cast<ReturnType>(tmp_bs.to_ulong()));
-    }
+4) Cast it to the field's value type.                 [uint16_t]                       0x00'0d
 
-    bool all_field_bits_set(const boost::dynamic_bitset<uint8_t>& bs, const boost::dynamic_bitset<uint8_t>& mask_bs)
-    {
-        auto tmp_bs{ bs & mask_bs };
-        return tmp_bs.to_ulong() == mask_bs.to_ulong();
-    }
+Bit fields are known at compile time, so all these steps reduce to a few loads, shifts and ands (see BitField.hpp).
+*/
+
+namespace TS
+{
+    // Containers of parse products are moved when they grow, and a copy would allocate from the heap instead of the arena
+    static_assert(std::is_nothrow_move_constructible_v<TableHeader>);
+    static_assert(std::is_nothrow_move_constructible_v<ESSD>);
 
-    bool all_field_bits_unset(const boost::dynamic_bitset<uint8_t>& bs, const boost::dynamic_bitset<uint8_t>& mask_bs)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse(buffer_type& p_buffer)
     {
-        auto tmp_bs{ bs & mask_bs };
-        return tmp_bs.to_ulong() == 0;
+        // Sections completed by, and products of, the previous packet are not referenced anymore
+        _packet.adaptation_field.reset();
+        _packet.payload_data.reset();
+        _arena.reset();
+        _section_assembler.release_completed();
+        _dropped_section_result = {};
+
+        ParseResult result{ parse_packet(p_buffer) };
+
+        _packet_index++;
+        return result;
     }
 
-    void PacketParser::parse(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_packet(buffer_type& p_buffer)
     {
-        parse_header(p_buffer);
-
+        if (auto result{ parse_header(p_buffer) }; not result)
+        {
+            return result;
+        }
         if (_packet.has_adaptation_field())
         {
-            parse_adaptation_field(p_buffer);
+            if (auto result{ parse_adaptation_field(p_buffer) }; not result)
+            {
+                return result;
+            }
         }
         if (_packet.has_payload_data())
         {
-            parse_payload_data(p_buffer);
+            return parse_payload_data(p_buffer);
         }
-
-        PacketParser::_packet_index++;
+        return {};
     }
 
-    void PacketParser::parse_header(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_header(buffer_type& p_buffer)
     {
-        // Create bitset from packet buffer
-        auto header_bs = from_packet_buffer<header_size>(p_buffer);
+        // Read from packet buffer
+        auto header_buffer = p_buffer.read(header_size);
 
         // Set fields
         Header& hdr = _packet.header;
 
-        hdr.sync_byte = read_field<uint8_t>(header_bs, hdr_sync_byte_mask_bs);
-        hdr.transport_error_indicator = header_bs.test(hdr_transport_error_indicator_mask_bs.find_first());
+        hdr.sync_byte = hdr_sync_byte_field.read(header_buffer);
+        hdr.transport_error_indicator = hdr_transport_error_indicator_field.read(header_buffer);
+
+        if (hdr.sync_byte != sync_byte_valid_value) { return ParseError::Invalid_sync_byte; }
+        if (hdr.transport_error_indicator) { return ParseError::Transport_error; }
 
-        if (hdr.sync_byte != sync_byte_valid_value) { throw InvalidSyncByte{}; }
-        if (hdr.transport_error_indicator) { throw TransportError{}; }
+        hdr.payload_unit_start_indicator = hdr_payload_unit_start_indicator_field.read(header_buffer);
+        hdr.transport_priority = hdr_transport_priority_field.read(header_buffer);
+        hdr.PID = hdr_PID_field.read(header_buffer);
+        hdr.transport_scrambling_control = hdr_transport_scrambling_control_field.read(header_buffer);
+        hdr.adaptation_field_control = hdr_adaptation_field_control_field.read(header_buffer);
+        hdr.continuity_counter = hdr_continuity_counter_field.read(header_buffer);
 
-        hdr.payload_unit_start_indicator = header_bs.test(hdr_payload_unit_start_indicator_mask_bs.find_first());
-        hdr.transport_priority = header_bs.test(hdr_transport_priority_mask_bs.find_first());
-        hdr.PID = read_field<uint16_t>(header_bs, hdr_PID_mask_bs);
-        hdr.transport_scrambling_control = read_field<uint8_t>(header_bs, hdr_transport_scrambling_control_mask_bs);
-        hdr.adaptation_field_control = read_field<uint8_t>(header_bs, hdr_adaptation_field_control_mask_bs);
-        hdr.continuity_counter = read_field<uint8_t>(header_bs, hdr_continuity_counter_mask_bs);
+        // NIT and PMT PIDs depend on the PAT tables processed so far
+        _packet.carries_NIT = hdr.PID == _context.NIT_pid.get_NIT_PID();
+        _packet.carries_PMT = _context.PSI_tables.is_PMT_PID(hdr.PID);
+        return {};
     }
 
-    void PacketParser::parse_adaptation_field(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_adaptation_field(buffer_type& p_buffer)
     {
         _packet.adaptation_field = AdaptationField{};
 
@@ -133,6 +119,7 @@ namespace TS
         AdaptationField& af = *_packet.adaptation_field;
 
         af.length = *cbegin(af_buffer);
+        if (af.length > p_buffer.size_not_read()) { return ParseError::Invalid_adaptation_field_length; }
 
         if (af.length > 0)
         {
@@ -140,32 +127,35 @@ namespace TS
         }
         if (af.length > af_flags_size)
         {
-            parse_adaptation_field_optional(p_buffer);
+            return parse_adaptation_field_optional(p_buffer);
         }
+        return {};
     }
 
-    void PacketParser::parse_adaptation_field_flags(PacketBuffer& p_buffer)
+    template <typename Layout>
+    void BasicPacketParser<Layout>::parse_adaptation_field_flags(buffer_type& p_buffer)
     {
         _packet.adaptation_field->flags = AdaptationFieldFlags{};
 
-        // Create bitset from packet buffer
-        auto af_bs = from_packet_buffer<af_flags_size>(p_buffer);
+        // Read from packet buffer
+        auto af_buffer = p_buffer.read(af_flags_size);
 
         // Set fields
         AdaptationField& af = *_packet.adaptation_field;
         AdaptationFieldFlags& aff = *af.flags;
 
-        aff.discontinuity_indicator = af_bs.test(af_discontinuity_indicator_mask_bs.find_first());
-        aff.random_access_indicator = af_bs.test(af_random_access_indicator_mask_bs.find_first());
-        aff.elementary_stream_priority_indicator = af_bs.test(af_elementary_stream_priority_indicator_mask_bs.find_first());
-        aff.PCR_flag = af_bs.test(af_PCR_flag_mask_bs.find_first());
-        aff.OPCR_flag = af_bs.test(af_OPCR_flag_mask_bs.find_first());
-        aff.splicing_point_flag = af_bs.test(af_splicing_point_flag_mask_bs.find_first());
-        aff.transport_private_data_flag = af_bs.test(af_transport_private_data_flag_mask_bs.find_first());
-        aff.extension_flag = af_bs.test(af_extension_flag_mask_bs.find_first());
+        aff.discontinuity_indicator = af_discontinuity_indicator_field.read(af_buffer);
+        aff.random_access_indicator = af_random_access_indicator_field.read(af_buffer);
+        aff.elementary_stream_priority_indicator = af_elementary_stream_priority_indicator_field.read(af_buffer);
+        aff.PCR_flag = af_PCR_flag_field.read(af_buffer);
+        aff.OPCR_flag = af_OPCR_flag_field.read(af_buffer);
+        aff.splicing_point_flag = af_splicing_point_flag_field.read(af_buffer);
+        aff.transport_private_data_flag = af_transport_private_data_flag_field.read(af_buffer);
+        aff.extension_flag = af_extension_flag_field.read(af_buffer);
     }
 
-    void PacketParser::parse_adaptation_field_optional(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_adaptation_field_optional(buffer_type& p_buffer)
     {
         _packet.adaptation_field->optional = AdaptationFieldOptional{};
 
@@ -176,20 +166,26 @@ namespace TS
 
         auto af_optional_size{ 0 };
 
+        // Optional fields can't go past the end of the adaptation field
+        auto fits = [&af, &af_optional_size](size_t size) { return af_flags_size + af_optional_size + size <= af.length; };
+
         if (aff.PCR_flag)
         {
-            afo.PCR = from_packet_buffer<afo_PCR_size>(p_buffer);
+            if (not fits(afo_PCR_size)) { return ParseError::Invalid_adaptation_field_length; }
+            afo.PCR = parse_program_clock_reference(p_buffer);
             af_optional_size += afo_PCR_size;
         }
 
         if (aff.OPCR_flag)
         {
-            afo.OPCR = from_packet_buffer<afo_OPCR_size>(p_buffer);
+            if (not fits(afo_OPCR_size)) { return ParseError::Invalid_adaptation_field_length; }
+            afo.OPCR = parse_program_clock_reference(p_buffer);
             af_optional_size += afo_OPCR_size;
         }
 
         if (aff.splicing_point_flag)
         {
+            if (not fits(afo_splicing_countdown_size)) { return ParseError::Invalid_adaptation_field_length; }
             auto splice_countdown_buffer = p_buffer.read(afo_splicing_countdown_size);
             afo.splice_countdown = static_cast<int8_t>(*cbegin(splice_countdown_buffer));
             af_optional_size += afo_splicing_countdown_size;
@@ -198,6 +194,7 @@ namespace TS
         if (aff.transport_private_data_flag)
         {
             // Length
+            if (not fits(afo_transport_private_data_length_size)) { return ParseError::Invalid_adaptation_field_length; }
             auto transport_private_data_length_buffer = p_buffer.read(afo_transport_private_data_length_size);
             afo.transport_private_data_length = *cbegin(transport_private_data_length_buffer);
             af_optional_size += afo_transport_private_data_length_size;
@@ -205,6 +202,7 @@ namespace TS
             // Data
             if (afo.transport_private_data_length != 0)
             {
+                if (not fits(*afo.transport_private_data_length)) { return ParseError::Invalid_adaptation_field_length; }
                 afo.transport_private_data = p_buffer.read(*afo.transport_private_data_length);
                 af_optional_size += *afo.transport_private_data_length;
             }
@@ -212,8 +210,17 @@ namespace TS
 
         if (aff.extension_flag)
         {
-            parse_adaptation_extension(p_buffer);
-            af_optional_size += afo.extension->length;
+            // The extension length doesn't count the length byte itself
+            if (not fits(adaptation_extension_header_size)) { return ParseError::Invalid_adaptation_field_length; }
+            if (not fits(ae_length_size + ae_length_field.read(p_buffer.peek(ae_length_size))))
+            {
+                return ParseError::Invalid_adaptation_field_length;
+            }
+            if (auto result{ parse_adaptation_extension(p_buffer) }; not result)
+            {
+                return result;
+            }
+            af_optional_size += ae_length_size + afo.extension->length;
         }
 
         if (auto af_stuffing_bytes_size = af.length - af_flags_size - af_optional_size;
@@ -224,84 +231,187 @@ namespace TS
             if (std::any_of(cbegin(*afo.stuffing_bytes), cend(*afo.stuffing_bytes),
                 [](uint8_t b) { return b != stuffing_byte; }))
             {
-                throw InvalidStuffingBytes{};
+                return ParseError::Invalid_stuffing_bytes;
             }
         }
+        return {};
+    }
+
+    template <typename Layout>
+    ProgramClockReference BasicPacketParser<Layout>::parse_program_clock_reference(buffer_type& p_buffer)
+    {
+        // Read from packet buffer
+        auto pcr_buffer = p_buffer.read(afo_PCR_size);
+
+        // Set fields
+        ProgramClockReference pcr{};
+
+        pcr.base = afo_PCR_base_field.read(pcr_buffer);
+        pcr.extension = afo_PCR_extension_field.read(pcr_buffer);
+
+        return pcr;
     }
 
-    void PacketParser::parse_adaptation_extension(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_adaptation_extension(buffer_type& p_buffer)
     {
         _packet.adaptation_field->optional->extension = AdaptationExtension{};
 
-        // Create bitset from packet buffer
-        auto ae_bs = from_packet_buffer<adaptation_extension_header_size>(p_buffer);
+        // Read from packet buffer
+        auto ae_buffer = p_buffer.read(adaptation_extension_header_size);
 
         AdaptationExtension& ae = *_packet.adaptation_field->optional->extension;
 
         // Set length
-        ae.length = read_field<uint8_t>(ae_bs, ae_length_mask_bs);
+        ae.length = ae_length_field.read(ae_buffer);
 
         // Set flags
-        ae.legal_time_window_flag = ae_bs.test(ae_legal_time_window_flag_mask_bs.find_first());
-        ae.piecewise_rate_flag = ae_bs.test(ae_piecewise_rate_flag_mask_bs.find_first());
-        ae.seamless_splice_flag = ae_bs.test(ae_seamless_splice_flag_mask_bs.find_first());
-        ae.reserved = read_field<uint8_t>(ae_bs, ae_reserved_mask_bs);
+        ae.legal_time_window_flag = ae_legal_time_window_flag_field.read(ae_buffer);
+        ae.piecewise_rate_flag = ae_piecewise_rate_flag_field.read(ae_buffer);
+        ae.seamless_splice_flag = ae_seamless_splice_flag_field.read(ae_buffer);
+        ae.reserved = ae_reserved_field.read(ae_buffer);
+
+        auto ae_size{ ae_flags_size };
+
+        // Optional fields can't go past the end of the adaptation extension
+        auto fits = [&ae, &ae_size](size_t size) { return ae_size + size <= ae.length; };
+
+        if (not fits(0)) { return ParseError::Invalid_adaptation_field_length; }
 
         // Set optional fields
         if (ae.legal_time_window_flag)
         {
-            auto ltw_bs = from_packet_buffer<aeo_LTW_field_size>(p_buffer);
+            if (not fits(aeo_LTW_field_size)) { return ParseError::Invalid_adaptation_field_length; }
+            auto ltw_buffer = p_buffer.read(aeo_LTW_field_size);
 
-            ae.legal_time_window_valid_flag = ltw_bs.test(aeo_legal_time_window_valid_flag_mask_bs.find_first());
-            ae.legal_time_window_offset = read_field<uint16_t>(ltw_bs, aeo_legal_time_window_offset_mask_bs);
+            ae.legal_time_window_valid_flag = aeo_legal_time_window_valid_flag_field.read(ltw_buffer);
+            ae.legal_time_window_offset = aeo_legal_time_window_offset_field.read(ltw_buffer);
+            ae_size += aeo_LTW_field_size;
         }
         if (ae.piecewise_rate_flag)
         {
-            auto piecewise_bs = from_packet_buffer<aeo_piecewise_field_size>(p_buffer);
+            if (not fits(aeo_piecewise_field_size)) { return ParseError::Invalid_adaptation_field_length; }
+            auto piecewise_buffer = p_buffer.read(aeo_piecewise_field_size);
 
-            ae.piecewise_rate_reserved = read_field<uint8_t>(piecewise_bs, aeo_piecewise_rate_reserved_mask_bs);
-            ae.piecewise_rate = read_field<uint32_t>(piecewise_bs, aeo_piecewise_rate_mask_bs);
+            ae.piecewise_rate_reserved = aeo_piecewise_rate_reserved_field.read(piecewise_buffer);
+            ae.piecewise_rate = aeo_piecewise_rate_field.read(piecewise_buffer);
+            ae_size += aeo_piecewise_field_size;
         }
         if (ae.seamless_splice_flag)
         {
-            auto seamless_bs = from_packet_buffer<aeo_seamless_field_size>(p_buffer);
+            if (not fits(aeo_seamless_field_size)) { return ParseError::Invalid_adaptation_field_length; }
+            auto seamless_buffer = p_buffer.read(aeo_seamless_field_size);
 
-            ae.seamless_splice_type = read_field<uint8_t>(seamless_bs, aeo_seamless_splice_type_mask_bs);
-            ae.DTS_next_access_unit = read_field<uint64_t>(seamless_bs, aeo_DTS_next_access_unit_mask_bs);
+            ae.seamless_splice_type = aeo_seamless_splice_type_field.read(seamless_buffer);
+            ae.DTS_next_access_unit = read_timestamp(seamless_buffer);
+            ae_size += aeo_seamless_field_size;
+        }
+
+        // Skip the reserved bytes at the end of the extension
+        if (ae.length > ae_size)
+        {
+            p_buffer.read(ae.length - ae_size);
         }
+        return {};
     }
 
-    void PacketParser::parse_payload_data(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_payload_data(buffer_type& p_buffer)
     {
-        _packet.payload_data = PayloadData{};
+        // Containers are created with the arena as their allocator, and are moved, so they keep it
+        _packet.payload_data.emplace(PayloadData{ .table_headers = std::pmr::vector<TableHeader>{ _arena.get_resource() } });
 
         // Check if we are parsing a PSI or a PES payload
         if (_packet.payload_contains_PSI())
         {
-            parse_payload_data_as_PSI(p_buffer);
-        }
-        else
-        {
-            parse_payload_data_as_PES(p_buffer);
+            return parse_payload_data_as_PSI(p_buffer);
         }
+        parse_payload_data_as_PES(p_buffer);
+        return {};
     }
 
-    void PacketParser::parse_payload_data_as_PES(PacketBuffer& p_buffer)
+    template <typename Layout>
+    void BasicPacketParser<Layout>::parse_payload_data_as_PES(buffer_type& p_buffer)
     {
         _packet.payload_data->PES_data = p_buffer.read(p_buffer.size_not_read());
     }
 
-    void PacketParser::parse_payload_data_as_PSI(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_payload_data_as_PSI(buffer_type& p_buffer)
     {
-        if (_packet.get_payload_unit_start_indicator())
+        const uint16_t pid{ _packet.header.PID };
+        const uint8_t cc{ _packet.header.continuity_counter };
+        std::optional<byte_buffer_view> section{};
+
+        if (not _packet.get_payload_unit_start_indicator())
         {
-            parse_pointer(p_buffer);
+            // No section starts in this packet: it can only continue a section started in a previous packet
+            if (auto result{ _section_assembler.append(pid, cc, p_buffer.read(p_buffer.size_not_read()), section) }; not result)
+            {
+                return result;
+            }
+            return section ? parse_section(*section) : ParseResult{};
+        }
+
+        if (auto result{ parse_pointer(p_buffer) }; not result)
+        {
+            return result;
+        }
+
+        // Bytes between the pointer field and the pointed position end a section started in a previous packet
+        if (_section_assembler.is_assembling(pid))
+        {
+            const Pointer& ptr = *_packet.payload_data->pointer;
+            if (auto result{ _section_assembler.append(pid, cc, ptr.pointer_filler_bytes.value_or(byte_buffer_view{}), section) };
+                not result)
+            {
+                // The previous section is lost, but the sections starting in this packet can still be parsed
+                _dropped_section_result = result;
+            }
+            else if (section)
+            {
+                if (auto result{ parse_section(*section) }; not result)
+                {
+                    return result;
+                }
+            }
+            else
+            {
+                // A new section starts in this packet, so the previous one can't be completed anymore
+                _section_assembler.abort(pid);
+            }
         }
 
-        parse_table_header(p_buffer);
+        // Sections starting in this packet, back to back, until the end of the packet or the stuffing bytes
+        while (p_buffer.size_not_read() != 0)
+        {
+            if (*cbegin(p_buffer.peek(1)) == stuffing_byte)
+            {
+                return parse_stuffing_bytes_section(p_buffer);
+            }
+
+            const size_t bytes_left{ p_buffer.size_not_read() };
+            const bool table_header_fits{ bytes_left >= table_header_size };
+            const size_t section_size{ table_header_fits
+                ? size_t{ table_header_size } + th_section_length_field.read(p_buffer.peek(table_header_size))
+                : size_t{ 0 } };
+            if (not table_header_fits or section_size > bytes_left)
+            {
+                // Section spanning across different packets
+                return _section_assembler.start(pid, cc, p_buffer.read(p_buffer.size_not_read()));
+            }
+
+            // Section contained in this packet: parse it in place
+            if (auto result{ parse_section(p_buffer.read(static_cast<uint8_t>(section_size))) }; not result)
+            {
+                return result;
+            }
+        }
+        return {};
     }
 
-    void PacketParser::parse_pointer(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_pointer(buffer_type& p_buffer)
     {
         _packet.payload_data->pointer = Pointer{};
 
@@ -312,198 +422,184 @@ namespace TS
         Pointer& ptr = *_packet.payload_data->pointer;
 
         ptr.pointer_field = *cbegin(ptr_buffer);  // pointer field
+        if (ptr.pointer_field > p_buffer.size_not_read()) { return ParseError::Invalid_pointer_field; }
 
         if (ptr.pointer_field != 0)
         {
             ptr.pointer_filler_bytes = p_buffer.read(ptr.pointer_field);  // pointer filler bytes
-
-            // If first of the filler bytes is 0xFF, then the rest of the bytes have to be 0xFF as well
-            if (not check_and_parse_stuffing_bytes_section(*ptr.pointer_filler_bytes))
-            {
-                throw Unimplemented("parsing of pointer filler bytes containing end of section");
-            }
         }
+        return {};
     }
 
-    void PacketParser::parse_table_header(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_section(const byte_buffer_view& section)
     {
-        _packet.payload_data->table_header = TableHeader{};
+        SectionReader s_reader{ section };
+        return parse_table_header(s_reader);
+    }
 
-        // Save packet buffer start read position
-        auto packet_buffer_start_pos = p_buffer.get_read_position();
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_table_header(SectionReader& s_reader)
+    {
+        TableHeader& th = _packet.payload_data->table_headers.emplace_back();
 
-        // Create bitset from packet buffer
-        auto th_bs = from_packet_buffer<table_header_size>(p_buffer);
+        // Read from section
+        auto th_buffer = s_reader.read(table_header_size);
 
         // Set fields
-        TableHeader& th = *_packet.payload_data->table_header;
-
-        th.table_id = read_field<uint8_t>(th_bs, th_table_id_mask_bs);
-
-        // Check end of table section repeat case
-        if (check_and_parse_stuffing_bytes_section(th.table_id, p_buffer.size_not_read(), p_buffer))
-        {
-            return;
-        }
-
-        th.section_syntax_indicator = th_bs.test(th_section_syntax_indicator_mask_bs.find_first());
-        th.private_bit = th_bs.test(th_private_bit_mask_bs.find_first());
-        th.section_length = read_field<uint16_t>(th_bs, th_section_length_mask_bs);
+        th.table_id = th_table_id_field.read(th_buffer);
+        th.section_syntax_indicator = th_section_syntax_indicator_field.read(th_buffer);
+        th.private_bit = th_private_bit_field.read(th_buffer);
+        th.section_length = th_section_length_field.read(th_buffer);
 
         // Checks
         bool payload_contains_PAT_CAT_or_PMT_table = _packet.payload_contains_PAT_table()
             || _packet.payload_contains_CAT_table()
             || _packet.payload_contains_PMT_table();
 
-        if (th.section_syntax_indicator != payload_contains_PAT_CAT_or_PMT_table) { throw InvalidSectionSyntaxIndicator{}; }
-        if (th.private_bit == payload_contains_PAT_CAT_or_PMT_table) { throw InvalidPrivateBit{}; }
-        if (not all_field_bits_set(th_bs, th_reserved_bits_mask_bs)) { throw InvalidReservedBits{}; }
-        if (not all_field_bits_unset(th_bs, th_section_length_unused_bits_mask_bs)) { throw InvalidUnusedBits{}; }
+        if (th.section_syntax_indicator != payload_contains_PAT_CAT_or_PMT_table) { return ParseError::Invalid_section_syntax_indicator; }
+        if (th.private_bit == payload_contains_PAT_CAT_or_PMT_table) { return ParseError::Invalid_private_bit; }
+        if (not th_reserved_bits_field.all_bits_set(th_buffer)) { return ParseError::Invalid_reserved_bits; }
+        if (not th_section_length_unused_bits_field.all_bits_unset(th_buffer)) { return ParseError::Invalid_unused_bits; }
+
+        if (th.section_length > th_max_section_length) { return ParseError::Invalid_section_length; }
 
-        if (th.section_length > th_max_section_length) { throw InvalidSectionLength{}; }
-        if (th.section_length > p_buffer.size_not_read()) { throw Unimplemented{ "PSI table spanning across different packets" }; }
-            
         if (th.has_syntax_section())
         {
-            parse_table_syntax_section(p_buffer);
-
-            // Save packet buffer end read position
-            auto packet_buffer_end_pos = p_buffer.get_read_position();
-
-            // Check CRC32
-            auto byte_count{ packet_buffer_end_pos - packet_buffer_start_pos - tss_crc32_size };
-            using crc_32_mpeg2 = boost::crc_optimal<32, 0x04C11DB7, 0xFFFFFFFF, 0x00000000, false, false>;
-            crc_32_mpeg2 result{};
-            result.process_bytes(p_buffer.data_as_char_pointer() + packet_buffer_start_pos, byte_count);
-            if (th.table_syntax->crc32 != result.checksum())
+            if (th.section_length < table_syntax_section_size + tss_crc32_size) { return ParseError::Invalid_section_length; }
+            if (auto result{ parse_table_syntax_section(s_reader) }; not result)
             {
-                throw InvalidCRC32{};
+                return result;
             }
-        }
-    }
 
-    bool PacketParser::check_and_parse_stuffing_bytes_section(const byte_buffer_view& buffer) const
-    {
-        if (*cbegin(buffer) == stuffing_byte)
-        {
-            if (std::any_of(cbegin(buffer) + 1, cend(buffer),
-                [](uint8_t b) { return b != stuffing_byte; }))
+            // Check CRC32
+            const byte_buffer_view section{ s_reader.data() };
+            if (th.table_syntax->crc32 != crc32_mpeg2(section.first(section.size() - tss_crc32_size)))
             {
-                throw InvalidStuffingBytes{};
+                return ParseError::Invalid_CRC32;
             }
-
-            return true;
         }
-
-        return false;
+        return {};
     }
 
-    bool PacketParser::check_and_parse_stuffing_bytes_section(
-        uint8_t first_byte, uint8_t bytes_to_read, PacketBuffer& p_buffer) const
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_stuffing_bytes_section(buffer_type& p_buffer) const
     {
-        if (first_byte == stuffing_byte)
-        {
-            auto buffer = p_buffer.read(bytes_to_read);
-
-            if (std::any_of(cbegin(buffer), cend(buffer),
-                [](uint8_t b) { return b != stuffing_byte; }))
-            {
-                throw InvalidStuffingBytes{};
-            }
+        // Stuffing bytes fill the rest of the packet
+        auto buffer = p_buffer.read(p_buffer.size_not_read());
 
-            return true;
+        if (std::any_of(cbegin(buffer), cend(buffer),
+            [](uint8_t b) { return b != stuffing_byte; }))
+        {
+            return ParseError::Invalid_stuffing_bytes;
         }
-        return false;
+        return {};
     }
 
-    void PacketParser::parse_table_syntax_section(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_table_syntax_section(SectionReader& s_reader)
     {
-        _packet.payload_data->table_header->table_syntax = TableSyntax{};
+        _packet.payload_data->table_headers.back().table_syntax = TableSyntax{};
 
-        // Create bitset from packet buffer
-        auto ts_bs = from_packet_buffer<table_syntax_section_size>(p_buffer);
+        // Read from section
+        auto ts_buffer = s_reader.read(table_syntax_section_size);
 
         // Set fields
-        TableSyntax& ts = *_packet.payload_data->table_header->table_syntax;
+        TableSyntax& ts = *_packet.payload_data->table_headers.back().table_syntax;
 
-        ts.table_id_extension = read_field<uint16_t>(ts_bs, tss_table_id_extension_mask_bs);
+        ts.table_id_extension = tss_table_id_extension_field.read(ts_buffer);
 
-        if (not all_field_bits_set(ts_bs, tss_reserved_bits_mask_bs)) { throw InvalidReservedBits{}; }
+        if (not tss_reserved_bits_field.all_bits_set(ts_buffer)) { return ParseError::Invalid_reserved_bits; }
 
-        ts.version_number = read_field<uint8_t>(ts_bs, tss_version_number_mask_bs);
-        ts.current_next_indicator = ts_bs.test(tss_current_next_indicator_mask_bs.find_first());
-        ts.section_number = read_field<uint8_t>(ts_bs, tss_section_number_mask_bs);
-        ts.last_section_number = read_field<uint8_t>(ts_bs, tss_last_section_number_mask_bs);
+        ts.version_number = tss_version_number_field.read(ts_buffer);
+        ts.current_next_indicator = tss_current_next_indicator_field.read(ts_buffer);
+        ts.section_number = tss_section_number_field.read(ts_buffer);
+        ts.last_section_number = tss_last_section_number_field.read(ts_buffer);
 
+        ParseResult result{};
         if (_packet.payload_contains_PAT_table())
         {
-            parse_PAT_table(p_buffer);
+            result = parse_PAT_table(s_reader);
         }
-        else if (_packet.payload_contains_CAT_table()) { throw Unimplemented{ "parsing of CAT table" }; }
-        else if (_packet.payload_contains_NIT_table()) { throw Unimplemented{ "parsing of NIT table" }; }
+        else if (_packet.payload_contains_CAT_table()) { return ParseError::Unimplemented_CAT_table; }
+        else if (_packet.payload_contains_NIT_table()) { return ParseError::Unimplemented_NIT_table; }
         else if (_packet.payload_contains_PMT_table())
         {
-            parse_PMT_table(p_buffer);
+            result = parse_PMT_table(s_reader);
+        }
+        if (not result)
+        {
+            return result;
         }
 
-        parse_CRC32(p_buffer);
+        parse_CRC32(s_reader);
+        return {};
     }
 
-    void PacketParser::parse_PAT_table(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_PAT_table(SectionReader& s_reader)
     {
         // Check PAT table size is not null
-        TableHeader& th = *_packet.payload_data->table_header;
+        TableHeader& th = _packet.payload_data->table_headers.back();
 
         const uint16_t table_data_size = th.section_length
             - table_syntax_section_size
             - tss_crc32_size;
         if (table_data_size == 0)
         {
-            return;
+            return {};
         }
+        if (table_data_size % PAT_table_data_program_size != 0) { return ParseError::Invalid_section_length; }
 
         // Create the PAT table
-        _packet.payload_data->table_header->table_syntax->table_data = PAT_Table{};
-
         TableSyntax& ts = *th.table_syntax;
-        PAT_Table& patt = std::get<PAT_Table>(ts.table_data);
+        PAT_Table& patt = ts.table_data.template emplace<PAT_Table>(
+            PAT_Table{ .data = decltype(PAT_Table::data){ _arena.get_resource() } });
+        patt.data.reserve(table_data_size / PAT_table_data_program_size);
 
         for (auto i = 0; i < table_data_size; i += PAT_table_data_program_size)
         {
-            // Create bitset from packet buffer
-            auto pat_entry_bs = from_packet_buffer<PAT_table_data_program_size>(p_buffer);
+            // Read from section
+            auto pat_entry_buffer = s_reader.read(PAT_table_data_program_size);
 
             // Set fields
-            if (not all_field_bits_set(pat_entry_bs, PAT_table_data_reserved_bits_mask_bs)) { throw InvalidReservedBits{}; }
+            if (not PAT_table_data_reserved_bits_field.all_bits_set(pat_entry_buffer)) { return ParseError::Invalid_reserved_bits; }
 
-            uint16_t program_num = read_field<uint16_t>(pat_entry_bs, PAT_table_data_table_id_extension_mask_bs);
-            uint16_t program_map_PID = read_field<uint16_t>(pat_entry_bs, PAT_table_data_program_map_PID_mask_bs);
+            uint16_t program_num = PAT_table_data_program_num_field.read(pat_entry_buffer);
+            uint16_t program_map_PID = PAT_table_data_program_map_PID_field.read(pat_entry_buffer);
 
             patt.data.push_back({ program_num, program_map_PID });
         }
+        return {};
     }
 
-    void PacketParser::parse_PMT_table(PacketBuffer& p_buffer)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_PMT_table(SectionReader& s_reader)
     {
+        if (_packet.payload_data->table_headers.back().section_length < table_syntax_section_size + PMT_table_data_header_size + tss_crc32_size)
+        {
+            return ParseError::Invalid_section_length;
+        }
+
         // Create the PMT table
-        _packet.payload_data->table_header->table_syntax->table_data = PMT_Table{};
+        _packet.payload_data->table_headers.back().table_syntax->table_data = PMT_Table{};
 
-        // Create bitset from packet buffer
-        auto td_bs = from_packet_buffer<PMT_table_data_header_size>(p_buffer);
+        // Read from section
+        auto td_buffer = s_reader.read(PMT_table_data_header_size);
 
         // Set fields
-        TableHeader& th = *_packet.payload_data->table_header;
+        TableHeader& th = _packet.payload_data->table_headers.back();
         TableSyntax& ts = *th.table_syntax;
         PMT_Table& pmtt = std::get<PMT_Table>(ts.table_data);
 
-        if (not all_field_bits_set(td_bs, PMT_reserved_bits_mask_bs)) { throw InvalidReservedBits{}; }
-        if (not all_field_bits_set(td_bs, PMT_reserved_bits_2_mask_bs)) { throw InvalidReservedBits{}; }
-        if (not all_field_bits_unset(td_bs, PMT_program_info_length_unused_bits_mask_bs)) { throw InvalidUnusedBits{}; }
+        if (not PMT_reserved_bits_field.all_bits_set(td_buffer)) { return ParseError::Invalid_reserved_bits; }
+        if (not PMT_reserved_bits_2_field.all_bits_set(td_buffer)) { return ParseError::Invalid_reserved_bits; }
+        if (not PMT_program_info_length_unused_bits_field.all_bits_unset(td_buffer)) { return ParseError::Invalid_unused_bits; }
 
-        pmtt.PCR_PID = read_field<uint16_t>(td_bs, PMT_reserved_bits_mask_bs);
-        pmtt.program_info_length = read_field<uint16_t>(td_bs, PMT_program_info_length_bs);
+        pmtt.PCR_PID = PMT_PCR_PID_field.read(td_buffer);
+        pmtt.program_info_length = PMT_program_info_length_field.read(td_buffer);
 
-        if (pmtt.program_info_length != 0) { throw Unimplemented{ "parsing of PTM program descriptors" }; }
+        if (pmtt.program_info_length != 0) { return ParseError::Unimplemented_program_descriptors; }
 
         uint16_t elementary_stream_specific_data_size = th.section_length
             - table_syntax_section_size
@@ -512,81 +608,95 @@ namespace TS
             - tss_crc32_size;
         if (elementary_stream_specific_data_size != 0)
         {
-            parse_elementary_stream_specific_data(p_buffer, elementary_stream_specific_data_size);
+            return parse_elementary_stream_specific_data(s_reader, elementary_stream_specific_data_size);
         }
+        return {};
     }
 
-    void PacketParser::parse_CRC32(PacketBuffer& p_buffer)
+    template <typename Layout>
+    void BasicPacketParser<Layout>::parse_CRC32(SectionReader& s_reader)
     {
-        // Create bitset from packet buffer
-        auto crc32_bs = from_packet_buffer<tss_crc32_size>(p_buffer);
+        // Read from section
+        auto crc32_buffer = s_reader.read(tss_crc32_size);
 
         // Set fields
-        TableSyntax& ts = *_packet.payload_data->table_header->table_syntax;
+        TableSyntax& ts = *_packet.payload_data->table_headers.back().table_syntax;
 
-        ts.crc32 = read_field<uint32_t>(crc32_bs, tss_crc32_mask_bs);
+        ts.crc32 = tss_crc32_field.read(crc32_buffer);
     }
 
-    void PacketParser::parse_elementary_stream_specific_data(PacketBuffer& p_buffer, uint16_t elementary_stream_specific_data_size)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_elementary_stream_specific_data(SectionReader& s_reader, uint16_t elementary_stream_specific_data_size)
     {
         // Create the ESSD info data
-        TableHeader& th = *_packet.payload_data->table_header;
+        TableHeader& th = _packet.payload_data->table_headers.back();
         TableSyntax& ts = *th.table_syntax;
         PMT_Table& pmtt = std::get<PMT_Table>(ts.table_data);
-        pmtt.ESSD_info_data = std::vector<ESSD>{};
+        pmtt.ESSD_info_data.emplace(_arena.get_resource());
 
         while (elementary_stream_specific_data_size)
         {
-            // Create bitset from packet buffer
-            auto essd_bs = from_packet_buffer<ESSD_header_size>(p_buffer);
+            if (elementary_stream_specific_data_size < ESSD_header_size) { return ParseError::Invalid_section_length; }
+
+            // Read from section
+            auto essd_buffer = s_reader.read(ESSD_header_size);
 
             // Set fields
-            ESSD essd{};
+            ESSD& essd = pmtt.ESSD_info_data->emplace_back();
 
-            if (not all_field_bits_set(essd_bs, ESSD_reserved_bits_mask_bs)) { throw InvalidReservedBits{}; }
-            if (not all_field_bits_set(essd_bs, ESSD_reserved_bits_2_mask_bs)) { throw InvalidReservedBits{}; }
-            if (not all_field_bits_unset(essd_bs, ESSD_info_length_unused_bits_mask_bs)) { throw InvalidUnusedBits{}; }
+            if (not ESSD_reserved_bits_field.all_bits_set(essd_buffer)) { return ParseError::Invalid_reserved_bits; }
+            if (not ESSD_reserved_bits_2_field.all_bits_set(essd_buffer)) { return ParseError::Invalid_reserved_bits; }
+            if (not ESSD_info_length_unused_bits_field.all_bits_unset(essd_buffer)) { return ParseError::Invalid_unused_bits; }
 
-            essd.stream_type = read_field<uint8_t>(essd_bs, ESSD_stream_type_mask_bs);
-            essd.elementary_PID = read_field<uint16_t>(essd_bs, ESSD_elementary_PID_mask_bs);
-            essd.info_length = read_field<uint16_t>(essd_bs, ESSD_info_length_mask_bs);
+            essd.stream_type = ESSD_stream_type_field.read(essd_buffer);
+            essd.elementary_PID = ESSD_elementary_PID_field.read(essd_buffer);
+            essd.info_length = ESSD_info_length_field.read(essd_buffer);
+            if (ESSD_header_size + essd.info_length > elementary_stream_specific_data_size) { return ParseError::Invalid_section_length; }
 
             if (essd.info_length != 0)
             {
-                essd.descriptors = parse_descriptors(p_buffer, essd.info_length);
+                essd.descriptors.emplace(_arena.get_resource());
+                if (auto result{ parse_descriptors(s_reader, essd.info_length, *essd.descriptors) }; not result)
+                {
+                    return result;
+                }
             }
 
-            pmtt.ESSD_info_data->push_back(essd);
-
             elementary_stream_specific_data_size -= (ESSD_header_size + essd.info_length);
         }
+        return {};
     }
 
-    std::vector<Descriptor> PacketParser::parse_descriptors(PacketBuffer& p_buffer, uint16_t descriptors_size)
+    template <typename Layout>
+    ParseResult BasicPacketParser<Layout>::parse_descriptors(SectionReader& s_reader, uint16_t descriptors_size, std::pmr::vector<Descriptor>& descriptors)
     {
-        std::vector<Descriptor> ret{};
-
         while (descriptors_size)
         {
-            // Create bitset from packet buffer
-            auto dsc_bs = from_packet_buffer<descriptor_header_size>(p_buffer);
+            if (descriptors_size < descriptor_header_size) { return ParseError::Invalid_section_length; }
+
+            // Read from section
+            auto dsc_buffer = s_reader.read(descriptor_header_size);
 
             // Set fields
             Descriptor descriptor{};
 
-            descriptor.tag = read_field<uint8_t>(dsc_bs, dsc_tag_mask_bs);
-            descriptor.length = read_field<uint8_t>(dsc_bs, dsc_length_mask_bs);
+            descriptor.tag = dsc_tag_field.read(dsc_buffer);
+            descriptor.length = dsc_length_field.read(dsc_buffer);
+            if (descriptor_header_size + descriptor.length > descriptors_size) { return ParseError::Invalid_section_length; }
 
             if (descriptor.length != 0)
             {
-                descriptor.data = p_buffer.read(descriptor.length);
+                descriptor.data = s_reader.read(descriptor.length);
             }
 
-            ret.push_back(descriptor);
+            descriptors.push_back(descriptor);
 
             descriptors_size -= (descriptor_header_size + descriptor.length);
         }
-
-        return ret;
+        return {};
     }
+
+    template class BasicPacketParser<TS_188_layout>;
+    template class BasicPacketParser<M2TS_192_layout>;
+    template class BasicPacketParser<TS_204_layout>;
 }
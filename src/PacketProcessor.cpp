@@ -1,14 +1,11 @@
-#include "Exception.hpp"
 #include "Packet.hpp"
 #include "PacketProcessor.hpp"
-#include "PES_Data.hpp"
-#include "PSI_Tables.hpp"
 
 #include <algorithm>
 
 namespace TS
 {
-    void PacketProcessor::process(const Packet& packet)
+    ParseResult PacketProcessor::process(const Packet& packet)
     {
         if (packet.has_payload_data())
         {
@@ -20,77 +17,124 @@ namespace TS
                     // TODO: should we store table data in PAT_map if current/next indicator is true,
                     //       and store table data in a buffer if current/next indicator is false?
                     // ****
-                    process_PAT_payload(packet);
+                    return process_PAT_payload(packet);
                 }
                 else if (packet.payload_contains_PMT_table())
                 {
-                    process_PMT_payload(packet);
+                    return process_PMT_payload(packet);
                 }
             }
             else
             {
-                process_PES_payload(packet);
+                return process_PES_payload(packet);
             }
         }
+        return {};
     }
 
-    void PacketProcessor::process_PAT_payload(const Packet& packet)
+    ParseResult PacketProcessor::process(const PacketView& packet)
     {
-        const TableSyntax& ts = *packet.payload_data->table_header->table_syntax;
+        if (packet.has_payload_data())
+        {
+            return process_PES_payload(packet);
+        }
+        return {};
+    }
 
-        if (not PSI_Tables::get_instance().PAT_needs_update(ts.version_number))
+    ParseResult PacketProcessor::process_PAT_payload(const Packet& packet)
+    {
+        for (const TableHeader& th : packet.payload_data->table_headers)
         {
-            return;
+            if (auto result{ process_PAT_section(*th.table_syntax) }; not result)
+            {
+                return result;
+            }
         }
+        return {};
+    }
 
-        const PAT_Table& patt = std::get<PAT_Table>(ts.table_data);
+    ParseResult PacketProcessor::process_PMT_payload(const Packet& packet)
+    {
+        for (const TableHeader& th : packet.payload_data->table_headers)
+        {
+            if (auto result{ process_PMT_section(packet.get_PID(), *th.table_syntax) }; not result)
+            {
+                return result;
+            }
+        }
+        return {};
+    }
 
-        std::for_each(cbegin(patt.data), cend(patt.data), [](const auto& program) {
-            auto program_num = program.first;
-            auto program_map_PID = program.second;
+    ParseResult PacketProcessor::process_PAT_section(const TableSyntax& ts)
+    {
+        if (not _context.PSI_tables.PAT_needs_update(ts.version_number, ts.section_number, ts.last_section_number))
+        {
+            return {};
+        }
 
+        const PAT_Table& patt = std::get<PAT_Table>(ts.table_data);
+
+        for (const auto& [program_num, program_map_PID] : patt.data)
+        {
             // Update PAT table
-            PSI_Tables::get_instance().set_PAT_program_number(program_map_PID, program_num);
+            if (auto result{ _context.PSI_tables.set_PAT_program_number(program_map_PID, program_num) }; not result)
+            {
+                return result;
+            }
 
             // Update NIT PID if needed
             if (program_num == NIT_program_num)
             {
-                NIT_PID::get_instance().set_NIT_PID(program_map_PID);
+                _context.NIT_pid.set_NIT_PID(program_map_PID);
             }
-        });
+        }
+        return {};
     }
 
-    void PacketProcessor::process_PMT_payload(const Packet& packet)
+    ParseResult PacketProcessor::process_PMT_section(uint16_t PMT_PID, const TableSyntax& ts)
     {
-        const TableSyntax& ts = *packet.payload_data->table_header->table_syntax;
-        auto program_num{ PSI_Tables::get_instance().get_PAT_program_number(packet.get_PID()) };
+        auto program_num{ _context.PSI_tables.get_PAT_program_number(PMT_PID) };
 
-        if (not PSI_Tables::get_instance().PMT_needs_update(program_num, ts.version_number))
+        if (not _context.PSI_tables.PMT_needs_update(program_num, ts.version_number, ts.section_number, ts.last_section_number))
         {
-            return;
+            return {};
         }
 
         // Update PMT table
         const PMT_Table& pmtt = std::get<PMT_Table>(ts.table_data);
+        if (not pmtt.ESSD_info_data)
+        {
+            return {};
+        }
+
+        for (const auto& essd : *pmtt.ESSD_info_data)
+        {
+            if (auto result{ _context.PSI_tables.set_PMT_stream_type(program_num, essd.elementary_PID, essd.stream_type) }; not result)
+            {
+                return result;
+            }
+        }
+        return {};
+    }
 
-        std::for_each(cbegin(*pmtt.ESSD_info_data), cend(*pmtt.ESSD_info_data), [&program_num](const auto& essd) {
-            PSI_Tables::get_instance().set_PMT_stream_type(program_num, essd.elementary_PID, essd.stream_type);
-            });
+    ParseResult PacketProcessor::process_PES_payload(const Packet& packet)
+    {
+        return process_PES_payload(packet.get_PID(), packet.get_payload_unit_start_indicator(), packet.payload_data->get_PES_data());
     }
 
-    void PacketProcessor::process_PES_payload(const Packet& packet)
+    ParseResult PacketProcessor::process_PES_payload(const PacketView& packet)
     {
-        auto PES_PID = packet.get_PID();
-        auto PES_data = packet.payload_data->get_PES_data();
+        return process_PES_payload(packet.get_PID(), packet.get_payload_unit_start_indicator(), packet.get_payload());
+    }
 
-        // Save PES data
-        if (PSI_Tables::get_instance().is_PES_PID(PES_PID))
-        {
-            PES_Data::get_instance().set_PES_data(PES_PID, PES_data);
-        }
-        else
+    ParseResult PacketProcessor::process_PES_payload(uint16_t PES_PID, bool payload_unit_start_indicator, const byte_buffer_view& PES_data)
+    {
+        // Strip PES headers, and save the elementary stream data and the PES header fields
+        if (not _context.PSI_tables.is_PES_PID(PES_PID))
         {
-            throw UnknownPES{};
+            return ParseError::Unknown_PES;
         }
+        _PES_assembler.assemble(PES_PID, payload_unit_start_indicator, PES_data);
+        return {};
     }
 }
@@ -0,0 +1,108 @@
+#include "Exception.hpp"
+#include "Packet.hpp"
+#include "PacketView.hpp"
+
+#include <iostream>
+
+namespace TS
+{
+    // Offsets (in bytes) within the packet
+    constexpr uint8_t af_length_offset{ header_size };
+    constexpr uint8_t af_flags_offset{ af_length_offset + af_length_size };
+    constexpr uint8_t afo_offset{ af_flags_offset + af_flags_size };
+
+    bool PacketView::has_adaptation_field() const
+    {
+        auto afc = get_adaptation_field_control();
+        return afc == 2 || afc == 3;
+    }
+
+    bool PacketView::has_payload_data() const
+    {
+        auto afc = get_adaptation_field_control();
+        return afc == 1 || afc == 3;
+    }
+
+    ParseResult PacketView::check_header() const
+    {
+        if (get_sync_byte() != sync_byte_valid_value) { return ParseError::Invalid_sync_byte; }
+        if (get_transport_error_indicator()) { return ParseError::Transport_error; }
+        if (header_size + af_length_size + get_adaptation_field_length() > packet_size) { return ParseError::Invalid_adaptation_field_length; }
+        return {};
+    }
+
+    uint8_t PacketView::get_adaptation_field_length() const
+    {
+        return has_adaptation_field() ? _packet[af_length_offset] : 0;
+    }
+
+    bool PacketView::has_adaptation_field_flags() const
+    {
+        return get_adaptation_field_length() >= af_flags_size;
+    }
+
+    bool PacketView::get_discontinuity_indicator() const
+    {
+        return has_adaptation_field_flags() and af_discontinuity_indicator_field.read(_packet.data() + af_flags_offset);
+    }
+
+    bool PacketView::get_random_access_indicator() const
+    {
+        return has_adaptation_field_flags() and af_random_access_indicator_field.read(_packet.data() + af_flags_offset);
+    }
+
+    std::optional<ProgramClockReference> PacketView::get_PCR() const
+    {
+        if (not has_adaptation_field_flags()
+            or not af_PCR_flag_field.read(_packet.data() + af_flags_offset)
+            or get_adaptation_field_length() < af_flags_size + afo_PCR_size)
+        {
+            return std::nullopt;
+        }
+
+        const uint8_t* pcr_buffer{ _packet.data() + afo_offset };
+        return ProgramClockReference{ afo_PCR_base_field.read(pcr_buffer), afo_PCR_extension_field.read(pcr_buffer) };
+    }
+
+    uint8_t PacketView::get_payload_offset() const
+    {
+        if (not _payload_offset)
+        {
+            uint16_t offset{ header_size };
+            if (has_adaptation_field())
+            {
+                offset += af_length_size + get_adaptation_field_length();
+            }
+            if (offset > packet_size)
+            {
+                throw InvalidAdaptationFieldLength{};
+            }
+            _payload_offset = static_cast<uint8_t>(offset);
+        }
+        return *_payload_offset;
+    }
+
+    const byte_buffer_view PacketView::get_payload() const
+    {
+        if (not has_payload_data())
+        {
+            return {};
+        }
+        return _packet.subspan(get_payload_offset());
+    }
+
+    /* friend */
+    std::ostream& operator<<(std::ostream& os, const PacketView& view)
+    {
+        os << "packet=[header={"
+            << "TEI=" << view.get_transport_error_indicator() << ", "
+            << "PUSI=" << view.get_payload_unit_start_indicator() << ", "
+            << "TP=" << view.get_transport_priority() << ", "
+            << "PID=0x" << std::hex << view.get_PID() << ", "
+            << "TSC=0x" << std::hex << static_cast<uint16_t>(view.get_transport_scrambling_control()) << ", "
+            << "AFC=0x" << std::hex << static_cast<uint16_t>(view.get_adaptation_field_control()) << ", "
+            << "CC=" << std::dec << static_cast<uint16_t>(view.get_continuity_counter())
+            << "}]";
+        return os;
+    }
+}
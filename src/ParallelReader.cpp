@@ -0,0 +1,327 @@
+#include "Demuxer.hpp"
+#include "Exception.hpp"
+#include "MappedFileSource.hpp"
+#include "PacketBuffer.hpp"
+#include "PacketView.hpp"
+#include "ParallelReader.hpp"
+#include "PES_Assembler.hpp"
+#include "PES_Data.hpp"
+#include "SyncScanner.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace TS
+{
+    template <typename Layout>
+    BasicParallelReader<Layout>::BasicParallelReader(
+        DemuxContext& context,
+        const std::filesystem::path& file_path,
+        WriterTable& writers,
+        const FileWriterOptions& writer_options,
+        const ParallelOptions& options)
+        : _context{ context }
+        , _file_path{ file_path }
+        , _writers{ writers }
+        , _writer_options{ writer_options }
+        , _options{ options }
+    {
+        if (_options.worker_count == 0)
+        {
+            _options.worker_count = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        // Fragments are only written to once, so there is nothing to preallocate
+        _writer_options.expected_size.reset();
+    }
+
+    template <typename Layout>
+    void BasicParallelReader<Layout>::run()
+    {
+        MappedFileSource source{ _file_path };
+        const byte_buffer_view file{ source.fill(SIZE_MAX) };
+
+        establish_PSI(file);
+
+        const std::vector<Chunk> chunks{ split(file) };
+        _errors.resize(chunks.size());
+        std::vector<std::thread> workers{};
+        for (size_t k{ 0 }; k < chunks.size(); ++k)
+        {
+            workers.emplace_back(&BasicParallelReader::read_chunk, this, file, k, chunks[k]);
+        }
+        std::for_each(begin(workers), end(workers), [](std::thread& worker) { worker.join(); });
+
+        if (auto it = std::find_if(cbegin(_errors), cend(_errors), [](const std::exception_ptr& error) { return error != nullptr; });
+            it != cend(_errors))
+        {
+            // Leave no fragments behind
+            for (size_t k{ 1 }; k < chunks.size(); ++k)
+            {
+                for (PID pid : _PES_PIDs.get_PIDs())
+                {
+                    std::error_code ec{};
+                    std::filesystem::remove(get_fragment_path(pid, k), ec);
+                }
+            }
+            std::rethrow_exception(*it);
+        }
+
+        stitch(chunks.size());
+    }
+
+    template <typename Layout>
+    void BasicParallelReader<Layout>::establish_PSI(const byte_buffer_view& file)
+    {
+        // Only PSI packets are demuxed
+        const std::vector<uint8_t> no_stream_types{};
+        WriterTable no_writers{ no_stream_types, _writer_options };
+        BasicDemuxer<Layout> demuxer{ _context, no_stream_types, no_writers, false };
+
+        const PSI_Tables& PSI_tables{ _context.PSI_tables };
+        MemorySource source{ file.first(std::min(file.size(), parallel_PSI_scan_size)) };
+        while (not PSI_tables.is_complete())
+        {
+            const byte_buffer_view record{ source.fill(Layout::stride) };
+            if (record.size() < Layout::stride)
+            {
+                break;
+            }
+
+            BasicPacketBuffer<Layout> buffer{ record };
+            if (const DemuxOutput output{ demuxer.demux(buffer) }; not output.result)
+            {
+                if (output.result.error() != ParseError::Invalid_sync_byte)
+                {
+                    throw std::runtime_error{ demuxer.get_error_message() };
+                }
+                // Workers report the loss of sync
+                (void) resynchronize(source, Layout::stride, Layout::prefix_size);
+                continue;
+            }
+            source.consume(Layout::stride);
+
+            // PES PIDs are demuxed from the packet following the PMT section that declares them
+            if (_writers.update(PSI_tables))
+            {
+                for (PID pid : _writers.get_PIDs())
+                {
+                    if (not _PES_PIDs.contains(pid))
+                    {
+                        _PES_PIDs[pid] = PES_PID_Info{ _writers.get_writer(pid), source.get_position() };
+                    }
+                }
+            }
+        }
+    }
+
+    template <typename Layout>
+    std::vector<typename BasicParallelReader<Layout>::Chunk> BasicParallelReader<Layout>::split(const byte_buffer_view& file) const
+    {
+        const size_t chunk_count{ std::clamp<size_t>(file.size() / min_parallel_chunk_size, 1, _options.worker_count) };
+
+        std::vector<Chunk> chunks(chunk_count);
+        for (size_t k{ 1 }; k < chunk_count; ++k)
+        {
+            // Chunks start at a packet in sync, so that the previous worker reads (and reports) any loss of sync up to there
+            const size_t split_position{ file.size() / chunk_count * k / Layout::stride * Layout::stride };
+            MemorySource source{ file.subspan(split_position) };
+            const byte_buffer_view window{ source.fill(resync_packet_count * Layout::stride) };
+            const bool at_end{ window.size() < resync_packet_count * Layout::stride };
+            if (find_sync_offset(window, Layout::stride, resync_packet_count, at_end, Layout::prefix_size) != Layout::prefix_size)
+            {
+                (void) resynchronize(source, Layout::stride, Layout::prefix_size);
+            }
+            const size_t begin{ std::max(split_position + source.get_position(), chunks[k - 1].begin) };
+            chunks[k - 1].end = begin;
+            chunks[k].begin = begin;
+        }
+        chunks.back().end = file.size();
+        return chunks;
+    }
+
+    template <typename Layout>
+    void BasicParallelReader<Layout>::read_chunk(const byte_buffer_view& file, size_t chunk_index, const Chunk& chunk)
+    {
+        try
+        {
+            // The first chunk is written straight to the final output files
+            std::vector<std::unique_ptr<FileWriter>> fragments{};
+            PID_Map<FileWriter*> writers{};
+            for (PID pid : _PES_PIDs.get_PIDs())
+            {
+                FileWriter* writer{ _PES_PIDs.at(pid).writer };
+                if (chunk_index != 0)
+                {
+                    fragments.push_back(std::make_unique<FileWriter>(writer->get_stream_type(), get_fragment_path(pid, chunk_index), _writer_options));
+                    writer = fragments.back().get();
+                }
+                writers[pid] = writer;
+            }
+
+            PES_Data PES_data{};
+            PES_Assembler assembler{ PES_data };
+            MemorySource source{ file.subspan(chunk.begin) };
+            const size_t chunk_size{ chunk.end - chunk.begin };
+
+            // Past the end of the chunk, only the PIDs with a PES packet in progress are read, until it ends
+            bool overrun{ false };
+            std::set<PID> open_PIDs{};
+            while (not _failed.load(std::memory_order_relaxed))
+            {
+                const size_t position{ source.get_position() };
+                const byte_buffer_view record{ source.fill(Layout::stride) };
+                if (record.size() < Layout::stride)
+                {
+                    // A file cut in the middle of a packet leaves a truncated packet at its end, which cannot be parsed
+                    if (not record.empty() and not overrun)
+                    {
+                        std::ostringstream oss{};
+                        oss << "Warning: truncated packet at the end of the file"
+                            << "\n\toffset=" << chunk.begin + position << ", size=" << record.size() << " bytes\n";
+                        warn(oss.str());
+                    }
+                    break;
+                }
+
+                PacketView view{ record.subspan(Layout::prefix_size, packet_size) };
+                if (view.get_sync_byte() != sync_byte_valid_value)
+                {
+                    // Lost sync: skip to the next position where the sync byte repeats at the packet stride
+                    auto skipped_bytes = resynchronize(source, Layout::stride, Layout::prefix_size);
+                    if (not overrun)
+                    {
+                        std::ostringstream oss{};
+                        oss << "Warning: " << InvalidSyncByte{}.what() << "\n\toffset=" << chunk.begin + position << "\n"
+                            << "\tresynchronized after skipping " << skipped_bytes << " bytes\n";
+                        warn(oss.str());
+                        _skipped_bytes += skipped_bytes;
+                    }
+                    continue;
+                }
+                source.consume(Layout::stride);
+
+                if (not overrun and position >= chunk_size)
+                {
+                    overrun = true;
+                    for (PID pid : _PES_PIDs.get_PIDs())
+                    {
+                        if (assembler.is_in_unit(pid)) { open_PIDs.insert(pid); }
+                    }
+                }
+                if (overrun and open_PIDs.empty())
+                {
+                    break;
+                }
+
+                // Drop packets we are not interested in just by looking at their PID
+                const PID pid{ view.get_PID() };
+                if (not _PES_PIDs.contains(pid) or chunk.begin + position < _PES_PIDs.at(pid).known_from)
+                {
+                    continue;
+                }
+                if (overrun)
+                {
+                    // The PES packet started on the next chunk belongs to the next worker
+                    if (not open_PIDs.contains(pid))
+                    {
+                        continue;
+                    }
+                    if (view.get_payload_unit_start_indicator())
+                    {
+                        open_PIDs.erase(pid);
+                        continue;
+                    }
+                }
+
+                try
+                {
+                    // Workers stop at the first error, whatever the error policy, as the error stops them all
+                    if (auto result{ view.check_header() }; not result)
+                    {
+                        throw_parse_error(result.error());
+                    }
+                    if (not view.has_payload_data())
+                    {
+                        continue;
+                    }
+                    assembler.assemble(pid, view.get_payload_unit_start_indicator(), view.get_payload());
+
+                    // Write elementary streams to output files
+                    writers.at(pid)->write(PES_data.get_ES_data(pid));
+                }
+                catch (const std::exception& err)
+                {
+                    std::ostringstream oss{};
+                    oss << err.what() << "\n\toffset=" << chunk.begin + position << ", " << view << "\n";
+                    throw std::runtime_error(oss.str().c_str());
+                }
+
+                if (overrun and not assembler.is_in_unit(pid))
+                {
+                    open_PIDs.erase(pid);
+                }
+            }
+
+            // Flush the fragments, so that errors on the last writes are reported
+            std::for_each(begin(fragments), end(fragments), [](std::unique_ptr<FileWriter>& fw_uptr) { fw_uptr->close(); });
+        }
+        catch (...)
+        {
+            fail(chunk_index);
+        }
+    }
+
+    template <typename Layout>
+    void BasicParallelReader<Layout>::stitch(size_t chunk_count)
+    {
+        for (size_t k{ 1 }; k < chunk_count; ++k)
+        {
+            for (PID pid : _PES_PIDs.get_PIDs())
+            {
+                const std::filesystem::path fragment_path{ get_fragment_path(pid, k) };
+                {
+                    StreamSource fragment{ fragment_path };
+                    for (byte_buffer_view block{ fragment.fill(stream_block_size) }; not block.empty(); block = fragment.fill(stream_block_size))
+                    {
+                        _PES_PIDs.at(pid).writer->write(block);
+                        fragment.consume(block.size());
+                    }
+                }
+                std::filesystem::remove(fragment_path);
+            }
+        }
+    }
+
+    template <typename Layout>
+    std::filesystem::path BasicParallelReader<Layout>::get_fragment_path(PID pid, size_t chunk_index) const
+    {
+        std::filesystem::path fragment_path{ _PES_PIDs.at(pid).writer->get_file_path() };
+        fragment_path += ".part" + std::to_string(chunk_index);
+        return fragment_path;
+    }
+
+    template <typename Layout>
+    void BasicParallelReader<Layout>::warn(const std::string& message)
+    {
+        std::lock_guard<std::mutex> lock{ _output_mutex };
+        _context.out << message;
+    }
+
+    template <typename Layout>
+    void BasicParallelReader<Layout>::fail(size_t chunk_index)
+    {
+        // Each worker keeps its own error, and the one of the first chunk wins
+        _errors[chunk_index] = std::current_exception();
+        _failed.store(true, std::memory_order_relaxed);
+    }
+
+    template class BasicParallelReader<TS_188_layout>;
+    template class BasicParallelReader<M2TS_192_layout>;
+    template class BasicParallelReader<TS_204_layout>;
+}
@@ -0,0 +1,76 @@
+#include "Exception.hpp"
+#include "ParseResult.hpp"
+
+#include <ostream>
+#include <stdexcept>
+
+namespace TS
+{
+    const char* get_message(ParseError error)
+    {
+        switch (error)
+        {
+        case ParseError::Invalid_sync_byte: return "invalid sync byte";
+        case ParseError::Transport_error: return "transport error";
+        case ParseError::Invalid_adaptation_field_length: return "invalid adaptation field length";
+        case ParseError::Invalid_pointer_field: return "invalid pointer field";
+        case ParseError::Invalid_stuffing_bytes: return "invalid stuffing bytes";
+        case ParseError::Invalid_section_syntax_indicator: return "invalid section syntax indicator";
+        case ParseError::Invalid_private_bit: return "invalid private bit";
+        case ParseError::Invalid_reserved_bits: return "invalid reserved bits";
+        case ParseError::Invalid_unused_bits: return "invalid unused bits";
+        case ParseError::Invalid_section_length: return "invalid section length";
+        case ParseError::Dropped_section: return "dropped PSI section";
+        case ParseError::Invalid_CRC32: return "invalid CRC32";
+        case ParseError::Unknown_PES: return "unknown PES";
+        case ParseError::Duplicated_PMT_PID: return "duplicated PMT PID";
+        case ParseError::Duplicated_PES_PID: return "duplicated PES PID";
+        case ParseError::Unknown_PMT_program_number: return "unknown PMT program number";
+        case ParseError::Unimplemented_CAT_table: return "unimplemented: parsing of CAT table";
+        case ParseError::Unimplemented_NIT_table: return "unimplemented: parsing of NIT table";
+        case ParseError::Unimplemented_program_descriptors: return "unimplemented: parsing of PTM program descriptors";
+        default: return "packet error";
+        }
+    }
+
+    void throw_parse_error(ParseError error)
+    {
+        switch (error)
+        {
+        case ParseError::Invalid_sync_byte: throw InvalidSyncByte{};
+        case ParseError::Transport_error: throw TransportError{};
+        case ParseError::Invalid_adaptation_field_length: throw InvalidAdaptationFieldLength{};
+        case ParseError::Invalid_pointer_field: throw InvalidPointerField{};
+        case ParseError::Invalid_stuffing_bytes: throw InvalidStuffingBytes{};
+        case ParseError::Invalid_section_syntax_indicator: throw InvalidSectionSyntaxIndicator{};
+        case ParseError::Invalid_private_bit: throw InvalidPrivateBit{};
+        case ParseError::Invalid_reserved_bits: throw InvalidReservedBits{};
+        case ParseError::Invalid_unused_bits: throw InvalidUnusedBits{};
+        case ParseError::Invalid_section_length: throw InvalidSectionLength{};
+        case ParseError::Dropped_section: throw DroppedSection{};
+        case ParseError::Invalid_CRC32: throw InvalidCRC32{};
+        case ParseError::Unknown_PES: throw UnknownPES{};
+        case ParseError::Duplicated_PMT_PID: throw Duplicated_PMT_PID{};
+        case ParseError::Duplicated_PES_PID: throw Duplicated_PES_PID{};
+        case ParseError::Unknown_PMT_program_number: throw Unknown_PMT_Program_Number{};
+        case ParseError::Unimplemented_CAT_table: throw Unimplemented{ "parsing of CAT table" };
+        case ParseError::Unimplemented_NIT_table: throw Unimplemented{ "parsing of NIT table" };
+        case ParseError::Unimplemented_program_descriptors: throw Unimplemented{ "parsing of PTM program descriptors" };
+        default: throw std::runtime_error{ get_message(error) };
+        }
+    }
+
+    /* friend */
+    std::ostream& operator<<(std::ostream& os, const ParseErrorCounts& counts)
+    {
+        os << "Parse errors: " << counts._total << " packets dropped\n";
+        for (size_t i{ 0 }; i < parse_error_count; ++i)
+        {
+            if (counts._counts[i] != 0)
+            {
+                os << "\t" << get_message(static_cast<ParseError>(i)) << " = " << counts._counts[i] << "\n";
+            }
+        }
+        return os;
+    }
+}
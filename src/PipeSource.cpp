@@ -0,0 +1,95 @@
+#include "Exception.hpp"
+#include "PipeSource.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+
+#if defined(_WIN32)
+    #include <fcntl.h>
+    #include <io.h>
+    #include <stdio.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace TS
+{
+    PipeSource::PipeSource()
+        : _file_path{ "-" }
+    {
+#if defined(_WIN32)
+        _fd = _fileno(stdin);
+        _setmode(_fd, _O_BINARY);
+#else
+        _fd = STDIN_FILENO;
+#endif
+    }
+
+    PipeSource::PipeSource(const std::filesystem::path& file_path)
+        : _file_path{ file_path }
+        , _owns_fd{ true }
+    {
+#if defined(_WIN32)
+        _fd = _wopen(file_path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+        _fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+        if (_fd < 0)
+        {
+            throw CouldNotOpenTSFile(file_path);
+        }
+    }
+
+    PipeSource::~PipeSource()
+    {
+        if (_owns_fd)
+        {
+#if defined(_WIN32)
+            _close(_fd);
+#else
+            ::close(_fd);
+#endif
+        }
+    }
+
+    byte_buffer_view PipeSource::fill(size_t n)
+    {
+        if (_end - _pos < n and not _at_end)
+        {
+            // Move the bytes not consumed yet to the front of the buffer, and read until the window is complete
+            std::copy(begin(_buffer) + _pos, begin(_buffer) + _end, begin(_buffer));
+            _end -= _pos;
+            _pos = 0;
+            if (_buffer.size() < n)
+            {
+                _buffer.resize(n);
+            }
+
+            while (_end < n)
+            {
+#if defined(_WIN32)
+                const auto read_size{ _read(_fd, _buffer.data() + _end, static_cast<unsigned>(_buffer.size() - _end)) };
+#else
+                const auto read_size{ ::read(_fd, _buffer.data() + _end, _buffer.size() - _end) };
+#endif
+                if (read_size < 0 and errno == EINTR)
+                {
+                    continue;
+                }
+                if (read_size < 0)
+                {
+                    throw CouldNotReadTSFile(_file_path);
+                }
+                if (read_size == 0)
+                {
+                    _at_end = true;
+                    break;
+                }
+                _end += static_cast<size_t>(read_size);
+            }
+        }
+        return { _buffer.data() + _pos, std::min(n, _end - _pos) };
+    }
+}
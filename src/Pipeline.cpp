@@ -0,0 +1,307 @@
+#include "Exception.hpp"
+#include "PacketBuffer.hpp"
+#include "PacketParser.hpp"
+#include "Pipeline.hpp"
+#include "SyncScanner.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+    #define NOMINMAX
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace TS
+{
+    namespace
+    {
+        void pin_to_cpu([[maybe_unused]] std::thread& thread, [[maybe_unused]] unsigned cpu)
+        {
+#if defined(_WIN32)
+            SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{ 1 } << (cpu % (sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+            cpu_set_t cpu_set{};
+            CPU_ZERO(&cpu_set);
+            CPU_SET(cpu % CPU_SETSIZE, &cpu_set);
+            pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set);
+#endif
+        }
+    }
+
+    template <typename Layout>
+    BasicPipeline<Layout>::BasicPipeline(DemuxContext& context, ByteSource& source, BasicDemuxer<Layout>& demuxer,
+        const PipelineOptions& options)
+        : _context{ context }
+        , _source{ source }
+        , _demuxer{ demuxer }
+        , _options{ options }
+    {
+        _options.batch_packet_count = std::max(_options.batch_packet_count, size_t{ 1 });
+        for (Batch& batch : _batches)
+        {
+            batch.records.resize(_options.batch_packet_count * Layout::stride);
+            _free_batches.push(&batch);
+        }
+    }
+
+    template <typename Layout>
+    void BasicPipeline<Layout>::run()
+    {
+        std::array<std::thread, 4> threads{
+            std::thread{ &BasicPipeline::read_stage, this },
+            std::thread{ &BasicPipeline::parse_stage, this },
+            std::thread{ &BasicPipeline::process_stage, this },
+            std::thread{ &BasicPipeline::write_stage, this }
+        };
+        if (_options.first_cpu)
+        {
+            for (unsigned i{ 0 }; i < threads.size(); ++i)
+            {
+                pin_to_cpu(threads[i], *_options.first_cpu + i);
+            }
+        }
+        std::for_each(begin(threads), end(threads), [](std::thread& thread) { thread.join(); });
+
+        if (_error)
+        {
+            std::rethrow_exception(_error);
+        }
+    }
+
+    template <typename Layout>
+    void BasicPipeline<Layout>::read_stage()
+    {
+        const size_t max_window_count{ _source.get_max_window_size() / Layout::stride };
+        size_t packet_index{ 0 };
+        bool at_end{ false };
+        bool last_sent{ false };
+        try
+        {
+            while (not at_end and not _failed.load(std::memory_order_relaxed))
+            {
+                Batch* batch{ pop(_free_batches, _queue_depths[0]) };
+                batch->count = 0;
+                batch->spans.clear();
+                batch->outputs.clear();
+
+                while (not at_end and batch->count < _options.batch_packet_count)
+                {
+                    // Batches bigger than the biggest window of the source are filled in several windows
+                    const size_t fill_count{ std::min(_options.batch_packet_count - batch->count, max_window_count) };
+                    const byte_buffer_view window{ _source.fill_available(fill_count * Layout::stride, Layout::stride) };
+                    const size_t window_count{ window.size() / Layout::stride };
+                    if (window_count == 0)
+                    {
+                        // A file cut in the middle of a packet leaves a truncated packet at its end, which cannot be parsed
+                        at_end = true;
+                        if (not window.empty())
+                        {
+                            _context.out << "Warning: truncated packet at the end of the file"
+                                << "\n\tindex=" << packet_index << ", size=" << window.size() << " bytes\n";
+                        }
+                        break;
+                    }
+
+                    // Take the packets up to the first one that lost sync
+                    size_t in_sync_count{ 0 };
+                    while (in_sync_count < window_count
+                        and window[in_sync_count * Layout::stride + Layout::prefix_size] == sync_byte_valid_value)
+                    {
+                        in_sync_count++;
+                    }
+                    std::copy_n(window.data(), in_sync_count * Layout::stride,
+                        batch->records.data() + batch->count * Layout::stride);
+                    batch->count += in_sync_count;
+                    packet_index += in_sync_count;
+                    _source.consume(in_sync_count * Layout::stride);
+
+                    if (in_sync_count < window_count)
+                    {
+                        // Lost sync: skip to the next position where the sync byte repeats at the packet stride
+                        _context.out << "Warning: " << InvalidSyncByte{}.what() << "\n\tindex=" << packet_index << "\n";
+                        auto skipped_bytes = resynchronize(_source, Layout::stride, Layout::prefix_size);
+                        _context.out << "\tresynchronized after skipping " << skipped_bytes << " bytes\n";
+                        _skipped_bytes += skipped_bytes;
+                    }
+                    else if (window_count < fill_count)
+                    {
+                        // Live inputs send the packets available so far, instead of waiting for a whole batch
+                        break;
+                    }
+                }
+
+                batch->last = at_end;
+                last_sent = at_end;
+                _read_batches.push(batch);
+            }
+        }
+        catch (...)
+        {
+            fail();
+        }
+
+        // The stages down the pipeline stop after the last batch
+        if (not last_sent)
+        {
+            Batch* batch{ pop(_free_batches, _queue_depths[0]) };
+            batch->count = 0;
+            batch->spans.clear();
+            batch->outputs.clear();
+            batch->last = true;
+            _read_batches.push(batch);
+        }
+    }
+
+    template <typename Layout>
+    void BasicPipeline<Layout>::parse_stage()
+    {
+        for (bool last{ false }; not last; )
+        {
+            Batch* batch{ pop(_read_batches, _queue_depths[1]) };
+            last = batch->last;
+            if (not _failed.load(std::memory_order_relaxed))
+            {
+                try
+                {
+                    BasicPacketParser<Layout>::parse_headers({ batch->records.data(), batch->count * Layout::stride }, batch->headers);
+                }
+                catch (...)
+                {
+                    fail();
+                }
+            }
+            _parsed_batches.push(batch);
+        }
+    }
+
+    template <typename Layout>
+    void BasicPipeline<Layout>::process_stage()
+    {
+        for (bool last{ false }; not last; )
+        {
+            Batch* batch{ pop(_parsed_batches, _queue_depths[2]) };
+            last = batch->last;
+            if (not _failed.load(std::memory_order_relaxed))
+            {
+                try
+                {
+                    for (size_t i{ 0 }; i < batch->count; ++i)
+                    {
+                        // Drop packets we are not interested in just by looking at their (already decoded) PID
+                        if (_demuxer.drop(batch->headers.PID[i]))
+                        {
+                            continue;
+                        }
+
+                        BasicPacketBuffer<Layout> buffer{ byte_buffer_view{ batch->records.data() + i * Layout::stride, Layout::stride } };
+                        const DemuxOutput output{ _demuxer.demux(buffer) };
+                        if (not output.result)
+                        {
+                            // Abort error policy (batches only hold packets in sync)
+                            throw std::runtime_error{ _demuxer.get_error_message() };
+                        }
+                        if (output.writer)
+                        {
+                            // The elementary stream data are views into the batch records, so they are valid until the batch is reused
+                            batch->outputs.push_back({ output.writer, batch->spans.size(), output.ES_data->size() });
+                            batch->spans.insert(end(batch->spans), cbegin(*output.ES_data), cend(*output.ES_data));
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    fail();
+                }
+            }
+            _processed_batches.push(batch);
+        }
+    }
+
+    template <typename Layout>
+    void BasicPipeline<Layout>::write_stage()
+    {
+        for (bool last{ false }; not last; )
+        {
+            Batch* batch{ pop(_processed_batches, _queue_depths[3]) };
+            last = batch->last;
+            if (not _failed.load(std::memory_order_relaxed))
+            {
+                try
+                {
+                    const std::span<const byte_buffer_view> spans{ batch->spans };
+                    for (const Output& output : batch->outputs)
+                    {
+                        output.writer->write(spans.subspan(output.first_span, output.span_count));
+                    }
+                }
+                catch (...)
+                {
+                    fail();
+                }
+            }
+            if (not last)
+            {
+                _free_batches.push(batch);
+            }
+        }
+    }
+
+    template <typename Layout>
+    typename BasicPipeline<Layout>::Batch* BasicPipeline<Layout>::pop(Queue& queue, QueueDepth& depth)
+    {
+        depth.sample(queue.size());
+        return queue.pop();
+    }
+
+    template <typename Layout>
+    void BasicPipeline<Layout>::fail()
+    {
+        // Keep the first error: the following ones may just be a consequence of it
+        std::lock_guard<std::mutex> lock{ _error_mutex };
+        if (not _error)
+        {
+            _error = std::current_exception();
+        }
+        _failed.store(true, std::memory_order_relaxed);
+    }
+
+    template <typename Layout>
+    std::ostream& operator<<(std::ostream& os, const BasicPipeline<Layout>& pipeline)
+    {
+        const std::array<const char*, 4> queue_names{
+            "free batches", "reader -> parser", "parser -> processor", "processor -> writer" };
+
+        const std::ios_base::fmtflags flags{ os.flags() };
+        const std::streamsize precision{ os.precision() };
+
+        os << "Pipeline queue depths (average/maximum batches):\n";
+        for (size_t i{ 0 }; i < queue_names.size(); ++i)
+        {
+            const QueueDepth& depth{ pipeline._queue_depths[i] };
+            os << "\t" << queue_names[i] << ": "
+                << std::fixed << std::setprecision(2) << depth.average() << "/" << depth.max << "\n";
+        }
+
+        os.flags(flags);
+        os.precision(precision);
+        return os;
+    }
+
+    template class BasicPipeline<TS_188_layout>;
+    template class BasicPipeline<M2TS_192_layout>;
+    template class BasicPipeline<TS_204_layout>;
+    template std::ostream& operator<<(std::ostream& os, const BasicPipeline<TS_188_layout>& pipeline);
+    template std::ostream& operator<<(std::ostream& os, const BasicPipeline<M2TS_192_layout>& pipeline);
+    template std::ostream& operator<<(std::ostream& os, const BasicPipeline<TS_204_layout>& pipeline);
+}
@@ -0,0 +1,144 @@
+#include "Packet.hpp"
+#include "SectionAssembler.hpp"
+
+#include <algorithm>
+
+namespace TS
+{
+    SectionBufferPool::SectionBufferPool()
+    {
+        grow();
+    }
+
+    void SectionBufferPool::grow()
+    {
+        _blocks.push_back(std::make_unique<buffer_type[]>(buffer_block_size));
+        _free_buffers.reserve(get_buffer_count());
+        for (size_t i{ 0 }; i < buffer_block_size; ++i)
+        {
+            _free_buffers.push_back(&_blocks.back()[i]);
+        }
+    }
+
+    SectionBufferPool::buffer_type* SectionBufferPool::acquire()
+    {
+        if (_free_buffers.empty())
+        {
+            if (get_buffer_count() >= max_buffer_count)
+            {
+                return nullptr;
+            }
+            grow();
+        }
+        buffer_type* ret{ _free_buffers.back() };
+        _free_buffers.pop_back();
+        return ret;
+    }
+
+    void SectionBufferPool::release(buffer_type* buffer)
+    {
+        _free_buffers.push_back(buffer);
+    }
+
+    /* static */
+    std::optional<size_t> SectionAssembler::get_section_size(const Assembly& assembly)
+    {
+        if (assembly.size < table_header_size)
+        {
+            return std::nullopt;
+        }
+        return table_header_size + th_section_length_field.read(assembly.buffer->data());
+    }
+
+    ParseResult SectionAssembler::start(PID p, uint8_t continuity_counter, const byte_buffer_view& bytes)
+    {
+        abort(p);
+
+        auto buffer = _pool.acquire();
+        if (not buffer)
+        {
+            return ParseError::Dropped_section;
+        }
+
+        // The caller has already checked the section doesn't fit in the packet, so it can't be complete yet
+        std::copy(cbegin(bytes), cend(bytes), buffer->begin());
+        _assemblies[p] = Assembly{ buffer, bytes.size(), continuity_counter };
+        return {};
+    }
+
+    ParseResult SectionAssembler::append(PID p, uint8_t continuity_counter, const byte_buffer_view& bytes,
+        std::optional<byte_buffer_view>& section)
+    {
+        section.reset();
+        if (not is_assembling(p))
+        {
+            return {};
+        }
+
+        Assembly& assembly{ _assemblies[p] };
+        if (continuity_counter == assembly.continuity_counter)
+        {
+            // Duplicated packet
+            return {};
+        }
+        if (continuity_counter != ((assembly.continuity_counter + 1) & 0xf))
+        {
+            // Lost packets
+            abort(p);
+            return ParseError::Dropped_section;
+        }
+        assembly.continuity_counter = continuity_counter;
+
+        // Copy the table header first, if still incomplete, as it tells the section size
+        auto bytes_it = cbegin(bytes);
+        if (assembly.size < table_header_size)
+        {
+            auto n = std::min<size_t>(table_header_size - assembly.size, bytes.size());
+            std::copy_n(bytes_it, n, assembly.buffer->begin() + assembly.size);
+            assembly.size += n;
+            bytes_it += n;
+        }
+        auto section_size = get_section_size(assembly);
+        if (not section_size)
+        {
+            return {};
+        }
+        if (*section_size > max_section_size)
+        {
+            abort(p);
+            return ParseError::Invalid_section_length;
+        }
+
+        // Copy the rest of the section (anything after its end is stuffing)
+        auto n = std::min<size_t>(*section_size - assembly.size, cend(bytes) - bytes_it);
+        std::copy_n(bytes_it, n, assembly.buffer->begin() + assembly.size);
+        assembly.size += n;
+        if (assembly.size < *section_size)
+        {
+            return {};
+        }
+
+        section = byte_buffer_view{ assembly.buffer->data(), assembly.size };
+        _completed.push_back(assembly.buffer);
+        assembly = Assembly{};
+        return {};
+    }
+
+    void SectionAssembler::abort(PID p)
+    {
+        if (is_assembling(p))
+        {
+            Assembly& assembly{ _assemblies[p] };
+            _pool.release(assembly.buffer);
+            assembly = Assembly{};
+        }
+    }
+
+    void SectionAssembler::release_completed()
+    {
+        std::for_each(cbegin(_completed), cend(_completed), [this](auto buffer) {
+            _pool.release(buffer);
+        });
+        _completed.clear();
+    }
+}
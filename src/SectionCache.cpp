@@ -0,0 +1,121 @@
+#include "Packet.hpp"
+#include "SectionCache.hpp"
+
+#include <algorithm>
+
+namespace TS
+{
+    /* static */
+    std::optional<SectionCache::SectionKey> SectionCache::get_section_key(const PacketView& packet)
+    {
+        if (not packet.get_payload_unit_start_indicator() or not packet.has_payload_data())
+        {
+            return std::nullopt;
+        }
+
+        const byte_buffer_view payload{ packet.get_payload() };
+        if (payload.empty())
+        {
+            return std::nullopt;
+        }
+
+        // Bytes before the pointed position would end a section started in a previous packet
+        if (payload[0] != 0)
+        {
+            return std::nullopt;
+        }
+
+        // Section following the pointer field
+        const size_t section_pos{ ptr_pointer_field_size };
+        if (section_pos + table_header_size > payload.size())
+        {
+            return std::nullopt;
+        }
+        const byte_buffer_view th_buffer{ payload.subspan(section_pos, table_header_size) };
+        if (not th_section_syntax_indicator_field.read(th_buffer))
+        {
+            return std::nullopt;
+        }
+        const size_t section_length{ th_section_length_field.read(th_buffer) };
+        const size_t section_end{ section_pos + table_header_size + section_length };
+        if (section_length < table_syntax_section_size + tss_crc32_size or section_end > payload.size())
+        {
+            return std::nullopt;
+        }
+
+        const byte_buffer_view tss_buffer{ payload.subspan(section_pos + table_header_size) };
+        return SectionKey{
+            .table_id = th_table_id_field.read(th_buffer),
+            .table_id_extension = tss_table_id_extension_field.read(tss_buffer),
+            .section_number = tss_section_number_field.read(tss_buffer),
+            .version_number = tss_version_number_field.read(tss_buffer),
+            .crc32 = tss_crc32_field.read(payload.subspan(section_end - tss_crc32_size))
+        };
+    }
+
+    bool SectionCache::contains(const PacketView& packet) const
+    {
+        if (not _entries.contains(packet.get_PID()))
+        {
+            return false;
+        }
+        auto key = get_section_key(packet);
+        if (not key)
+        {
+            return false;
+        }
+
+        const PID_Entries& pid_entries{ _entries.at(packet.get_PID()) };
+        auto it = std::find_if(cbegin(pid_entries.entries), cend(pid_entries.entries), [&key](const Entry& entry) {
+            return entry.in_use and entry.key.is_same_section(*key);
+        });
+        if (it == cend(pid_entries.entries) or it->key != *key)
+        {
+            return false;
+        }
+
+        const byte_buffer_view payload{ packet.get_payload() };
+        return std::equal(cbegin(payload), cend(payload), cbegin(it->payload), cbegin(it->payload) + it->payload_size);
+    }
+
+    void SectionCache::insert(const PacketView& packet)
+    {
+        auto key = get_section_key(packet);
+        const byte_buffer_view payload{ packet.get_payload() };
+
+        // Only the first section of the payload is keyed, so anything else than stuffing after it makes the packet not cacheable
+        const size_t section_end{ key
+            ? size_t{ ptr_pointer_field_size } + table_header_size + th_section_length_field.read(payload.subspan(ptr_pointer_field_size))
+            : size_t{ 0 } };
+        if (not key or std::any_of(cbegin(payload) + section_end, cend(payload), [](uint8_t b) { return b != stuffing_byte; }))
+        {
+            // Not cacheable (e.g. a section spanning across packets), and its identity is not known:
+            // forget whatever was cached for this PID
+            if (_entries.contains(packet.get_PID()))
+            {
+                _entries.at(packet.get_PID()) = PID_Entries{};
+            }
+            return;
+        }
+
+        // Replace the entry of the same section, or take a free one, or evict the oldest one
+        PID_Entries& pid_entries{ _entries[packet.get_PID()] };
+        auto it = std::find_if(begin(pid_entries.entries), end(pid_entries.entries), [&key](const Entry& entry) {
+            return entry.in_use and entry.key.is_same_section(*key);
+        });
+        if (it == end(pid_entries.entries))
+        {
+            it = std::find_if(begin(pid_entries.entries), end(pid_entries.entries), [](const Entry& entry) { return not entry.in_use; });
+        }
+        if (it == end(pid_entries.entries))
+        {
+            it = begin(pid_entries.entries) + pid_entries.next_eviction;
+            pid_entries.next_eviction = (pid_entries.next_eviction + 1) % max_sections_per_PID;
+        }
+
+        it->in_use = true;
+        it->key = *key;
+        it->payload_size = static_cast<uint8_t>(payload.size());
+        std::copy(cbegin(payload), cend(payload), begin(it->payload));
+    }
+}
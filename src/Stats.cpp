@@ -8,27 +8,107 @@
 
 namespace TS
 {
-    /* static */
-    Stats& Stats::get_instance()
+    void Stats::collect(const Packet& packet)
     {
-        static Stats instance;
-        return instance;
+        PacketInfo info{};
+        info.pid = packet.header.PID;
+        info.payload_unit_start_indicator = packet.header.payload_unit_start_indicator;
+        info.transport_scrambling_control = packet.header.transport_scrambling_control;
+        info.continuity_counter = packet.header.continuity_counter;
+        info.has_payload = packet.has_payload_data();
+        if (packet.has_adaptation_field() and packet.adaptation_field)
+        {
+            const AdaptationField& af{ *packet.adaptation_field };
+            info.discontinuity_indicator = af.flags and af.flags->discontinuity_indicator;
+            if (af.optional and af.optional->PCR)
+            {
+                info.PCR = af.optional->PCR->get_value();
+            }
+        }
+        collect(info);
     }
 
-    void Stats::collect(const Packet& packet)
+    void Stats::collect(const PacketView& packet)
+    {
+        PacketInfo info{};
+        info.pid = packet.get_PID();
+        info.payload_unit_start_indicator = packet.get_payload_unit_start_indicator();
+        info.transport_scrambling_control = packet.get_transport_scrambling_control();
+        info.continuity_counter = packet.get_continuity_counter();
+        info.has_payload = packet.has_payload_data();
+        if (packet.has_adaptation_field())
+        {
+            info.discontinuity_indicator = packet.get_discontinuity_indicator();
+            if (auto PCR{ packet.get_PCR() })
+            {
+                info.PCR = PCR->get_value();
+            }
+        }
+        collect(info);
+    }
+
+    void Stats::collect(const PacketInfo& info)
+    {
+        PID_Stats& pid_stats{ _PID_stats[info.pid] };
+        pid_stats.packet_count++;
+        if (info.payload_unit_start_indicator) { pid_stats.PUSI_count++; }
+        if (info.transport_scrambling_control != 0) { pid_stats.scrambled_count++; }
+        if (info.pid != null_PID and not pid_stats.CC.check(info.continuity_counter, info.has_payload, info.discontinuity_indicator))
+        {
+            pid_stats.CC_error_count++;
+        }
+        if (info.PCR) { collect_PCR(pid_stats, info); }
+        _packet_count++;
+    }
+
+    void Stats::collect_PCR(PID_Stats& pid_stats, const PacketInfo& info)
     {
-        _pids.insert(packet.header.PID);
+        const uint64_t PCR{ *info.PCR };
+        if (pid_stats.PCR_known and not info.discontinuity_indicator)
+        {
+            const uint64_t ticks{ (PCR + PCR_wrap_around - pid_stats.last_PCR) % PCR_wrap_around };
+            if (ticks != 0 and ticks <= max_PCR_interval)
+            {
+                _PCR_ticks += ticks;
+                _PCR_packets += _packet_count - pid_stats.last_PCR_packet_index;
+            }
+        }
+        pid_stats.last_PCR = PCR;
+        pid_stats.last_PCR_packet_index = _packet_count;
+        pid_stats.PCR_known = true;
+    }
+
+    std::optional<uint64_t> Stats::get_TS_bitrate() const
+    {
+        if (_PCR_ticks == 0)
+        {
+            return std::nullopt;
+        }
+        // bits / (ticks / 27 MHz), in floating point, as packets * bits * 27 MHz would overflow for long streams
+        return static_cast<uint64_t>(static_cast<double>(_PCR_packets) * packet_size * 8 * PCR_frequency / static_cast<double>(_PCR_ticks));
     }
 
     /* friend */
     std::ostream& operator<<(std::ostream& os, const Stats& stats)
     {
-        for (auto it = cbegin(stats._pids); it != cend(stats._pids); it = stats._pids.upper_bound(*it))
+        const std::optional<uint64_t> TS_bitrate{ stats.get_TS_bitrate() };
+        uint64_t CC_error_count{ 0 };
+        uint64_t scrambled_count{ 0 };
+
+        for (size_t i{ 0 }; i < stats._PID_stats.size(); ++i)
         {
+            const Stats::PID_Stats& pid_stats{ stats._PID_stats[i] };
+            if (pid_stats.packet_count == 0)
+            {
+                continue;
+            }
+            CC_error_count += pid_stats.CC_error_count;
+            scrambled_count += pid_stats.scrambled_count;
+
             std::string stream_info{ "unknown" };
 
-            const PSI_Tables& tables{ PSI_Tables::get_instance() };
-            PID pid{ *it };
+            const PSI_Tables& tables{ stats._PSI_tables };
+            PID pid{ static_cast<PID>(i) };
             if (tables.is_PES_PID(pid))
             {
                 uint8_t stream_type{ tables.get_PES_stream_type(pid) };
@@ -41,10 +121,25 @@ namespace TS
             }
 
             os << "PID: 0x" << std::hex << pid << std::dec
-                << "\tcount = " << stats._pids.count(*it)
-                << "\tstream info = " << stream_info
+                << "\tcount = " << pid_stats.packet_count
+                << "\tCC errors = " << pid_stats.CC_error_count
+                << "\tscrambled = " << pid_stats.scrambled_count
+                << "\tPUSI = " << pid_stats.PUSI_count;
+            if (TS_bitrate)
+            {
+                os << "\tbitrate = " << *TS_bitrate * pid_stats.packet_count / stats._packet_count << " bps";
+            }
+            os << "\tstream info = " << stream_info
                 << "\n";
         }
+
+        os << "Total: count = " << stats._packet_count
+            << "\tnull = " << stats._PID_stats[null_PID].packet_count
+            << "\tCC errors = " << CC_error_count
+            << "\tscrambled = " << scrambled_count
+            << "\tbitrate = ";
+        if (TS_bitrate) { os << *TS_bitrate << " bps (from PCR)"; } else { os << "unknown (no PCR)"; }
+        os << "\n";
         return os;
     }
 }
@@ -0,0 +1,180 @@
+#include "CpuFeatures.hpp"
+#include "Packet.hpp"
+#include "SyncScanner.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(TS_X86)
+    #include <immintrin.h>
+#endif
+
+namespace TS
+{
+    namespace
+    {
+        bool is_sync_offset(const uint8_t* data, size_t offset, size_t stride, size_t k)
+        {
+            for (size_t j{ 0 }; j < k; ++j)
+            {
+                if (data[offset + j * stride] != sync_byte_valid_value)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Returns the first offset in [begin, end) that is followed by k sync bytes at the packet stride
+        // All the offsets in that range must leave room for k packets
+        std::optional<size_t> find_sync_offset_scalar(const uint8_t* data, size_t begin, size_t end, size_t stride, size_t k)
+        {
+            for (size_t offset{ begin }; offset < end; ++offset)
+            {
+                auto candidate = static_cast<const uint8_t*>(std::memchr(data + offset, sync_byte_valid_value, end - offset));
+                if (candidate == nullptr)
+                {
+                    return std::nullopt;
+                }
+                offset = candidate - data;
+                if (is_sync_offset(data, offset, stride, k))
+                {
+                    return offset;
+                }
+            }
+            return std::nullopt;
+        }
+
+#if defined(TS_X86)
+        // Each lane of the comparison mask corresponds to one candidate offset,
+        // and it is only kept set if all the k bytes at the packet stride from that offset are sync bytes
+        TS_TARGET("avx2,bmi")
+        std::optional<size_t> find_sync_offset_avx2(const uint8_t* data, size_t& begin, size_t end, size_t stride, size_t k)
+        {
+            const __m256i sync{ _mm256_set1_epi8(static_cast<char>(sync_byte_valid_value)) };
+
+            for (; begin + 32 <= end; begin += 32)
+            {
+                uint32_t mask{ 0xffff'ffff };
+                for (size_t j{ 0 }; j < k and mask != 0; ++j)
+                {
+                    __m256i bytes{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + begin + j * stride)) };
+                    mask &= static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, sync)));
+                }
+                if (mask != 0)
+                {
+                    return begin + _tzcnt_u32(mask);
+                }
+            }
+            return std::nullopt;
+        }
+#endif
+    }
+
+    std::optional<size_t> find_sync_offset(const byte_buffer_view& buffer, size_t stride, size_t k, bool at_end,
+        size_t prefix_size)
+    {
+        const uint8_t* data{ buffer.data() };
+        const size_t size{ buffer.size() };
+
+        // Offsets in [0, full_end) leave room for k packets
+        const size_t span_size{ (k - 1) * stride + 1 };
+        const size_t full_end{ size >= span_size ? size - span_size + 1 : 0 };
+
+        size_t begin{ 0 };
+#if defined(TS_X86)
+        if (CpuFeatures::get_instance().has_AVX2())
+        {
+            if (auto offset = find_sync_offset_avx2(data, begin, full_end, stride, k))
+            {
+                return offset;
+            }
+        }
+#endif
+        if (auto offset = find_sync_offset_scalar(data, begin, full_end, stride, k))
+        {
+            return offset;
+        }
+
+        // At the end of the input, accept offsets followed by fewer than k packets,
+        // as long as they are all in sync and the last one ends exactly at the end of the input
+        if (at_end)
+        {
+            for (size_t offset{ std::max(full_end, prefix_size) }; offset - prefix_size + stride <= size; ++offset)
+            {
+                const size_t size_left{ size - (offset - prefix_size) };
+                if (size_left % stride == 0 and is_sync_offset(data, offset, stride, size_left / stride))
+                {
+                    return offset;
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    namespace
+    {
+        template <typename Layout>
+        std::optional<size_t> find_packet_start(const byte_buffer_view& buffer, bool at_end)
+        {
+            auto offset = find_sync_offset(buffer, Layout::stride, probe_packet_count, at_end, Layout::prefix_size);
+            if (offset and *offset >= Layout::prefix_size)
+            {
+                return *offset - Layout::prefix_size;
+            }
+            return std::nullopt;
+        }
+    }
+
+    std::optional<uint8_t> detect_packet_stride(const byte_buffer_view& buffer, bool at_end)
+    {
+        std::optional<uint8_t> ret{};
+        size_t ret_packet_start{ buffer.size() };
+
+        auto try_layout = [&](uint8_t stride, std::optional<size_t> packet_start) {
+            if (packet_start and *packet_start < ret_packet_start)
+            {
+                ret = stride;
+                ret_packet_start = *packet_start;
+            }
+        };
+        try_layout(TS_188_layout::stride, find_packet_start<TS_188_layout>(buffer, at_end));
+        try_layout(M2TS_192_layout::stride, find_packet_start<M2TS_192_layout>(buffer, at_end));
+        try_layout(TS_204_layout::stride, find_packet_start<TS_204_layout>(buffer, at_end));
+
+        return ret;
+    }
+
+    size_t resynchronize(ByteSource& source, uint8_t stride, uint8_t prefix_size)
+    {
+        // Start looking for the next sync position from the byte following the sync byte of the packet that lost sync
+        // Offsets are relative to the scan start, so the packet containing a sync position always starts after the lost one
+        const size_t scan_start{ prefix_size + 1u };
+
+        for (size_t skipped_bytes{ 0 }; ; )
+        {
+            const byte_buffer_view window{ source.fill(resync_window_size) };
+            const bool at_end{ window.size() < resync_window_size };
+            const byte_buffer_view scan_window{ window.subspan(std::min(scan_start, window.size())) };
+
+            if (auto offset = find_sync_offset(scan_window, stride, resync_packet_count, at_end, prefix_size))
+            {
+                const size_t packet_pos{ scan_start + *offset - prefix_size };
+                source.consume(packet_pos);
+                return skipped_bytes + packet_pos;
+            }
+            if (at_end)
+            {
+                // No sync position until the end of the file: the next fill will just hit the end of file
+                source.consume(window.size());
+                return skipped_bytes + window.size();
+            }
+
+            // Keep scanning from the first offset that did not leave room for a whole sync sequence
+            const size_t consumed{ scan_window.size() - (resync_packet_count - 1) * stride };
+            source.consume(consumed);
+            skipped_bytes += consumed;
+        }
+    }
+}
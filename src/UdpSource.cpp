@@ -0,0 +1,205 @@
+#include "UdpSource.hpp"
+
+#if TS_HAS_UDP_SOURCE
+
+#include "Exception.hpp"
+#include "Packet.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace TS
+{
+    namespace
+    {
+        // RTP fixed header, RFC 3550
+        constexpr size_t RTP_header_size{ 12 };
+        constexpr uint8_t RTP_version{ 2 };
+
+        sockaddr_in parse_udp_url(const std::string& url)
+        {
+            // udp://[@][<address>]:<port>
+            const std::string scheme_separator{ "://" };
+            std::string address{ url.substr(url.find(scheme_separator) + scheme_separator.size()) };
+            if (address.starts_with("@"))
+            {
+                address.erase(0, 1);
+            }
+            const auto colon{ address.rfind(':') };
+            if (colon == std::string::npos)
+            {
+                throw InvalidUdpAddress{ url };
+            }
+            const std::string host{ address.substr(0, colon) };
+            const std::string port_str{ address.substr(colon + 1) };
+
+            sockaddr_in socket_address{};
+            socket_address.sin_family = AF_INET;
+            socket_address.sin_addr.s_addr = htonl(INADDR_ANY);
+            if (not host.empty() and inet_pton(AF_INET, host.c_str(), &socket_address.sin_addr) != 1)
+            {
+                throw InvalidUdpAddress{ url };
+            }
+            if (port_str.empty() or port_str.size() > 5 or not std::all_of(begin(port_str), end(port_str), ::isdigit)
+                or std::stoul(port_str) == 0 or std::stoul(port_str) > 0xffff)
+            {
+                throw InvalidUdpAddress{ url };
+            }
+            socket_address.sin_port = htons(static_cast<uint16_t>(std::stoul(port_str)));
+            return socket_address;
+        }
+    }
+
+    UdpSource::UdpSource(const std::string& url, uint64_t idle_timeout_ms)
+        : _url{ url }
+        , _slots(udp_slot_count * udp_max_datagram_size)
+    {
+        const sockaddr_in socket_address{ parse_udp_url(url) };
+
+        _fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (_fd < 0)
+        {
+            throw CouldNotOpenUdpSocket{ url, std::strerror(errno) };
+        }
+        auto fail = [this, &url](const char* call) {
+            const std::string reason{ std::string{ call } + ": " + std::strerror(errno) };
+            ::close(_fd);
+            throw CouldNotOpenUdpSocket{ url, reason };
+        };
+
+        // Several readers can listen to the same multicast group
+        const int reuse{ 1 };
+        if (::setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0) { fail("setsockopt(SO_REUSEADDR)"); }
+        // The kernel may cap the receive buffer size, which is not an error
+        ::setsockopt(_fd, SOL_SOCKET, SO_RCVBUF, &udp_receive_buffer_size, sizeof(udp_receive_buffer_size));
+        if (idle_timeout_ms != 0)
+        {
+            timeval timeout{};
+            timeout.tv_sec = static_cast<time_t>(idle_timeout_ms / 1000);
+            timeout.tv_usec = static_cast<suseconds_t>((idle_timeout_ms % 1000) * 1000);
+            if (::setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0) { fail("setsockopt(SO_RCVTIMEO)"); }
+        }
+        if (::bind(_fd, reinterpret_cast<const sockaddr*>(&socket_address), sizeof(socket_address)) != 0) { fail("bind"); }
+        if (IN_MULTICAST(ntohl(socket_address.sin_addr.s_addr)))
+        {
+            ip_mreq membership{};
+            membership.imr_multiaddr = socket_address.sin_addr;
+            membership.imr_interface.s_addr = htonl(INADDR_ANY);
+            if (::setsockopt(_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) { fail("setsockopt(IP_ADD_MEMBERSHIP)"); }
+        }
+
+        // Every slot gets a message header of its own, set up once
+        for (size_t i{ 0 }; i < udp_slot_count; ++i)
+        {
+            _iovecs[i].iov_base = _slots.data() + i * udp_max_datagram_size;
+            _iovecs[i].iov_len = udp_max_datagram_size;
+            _headers[i].msg_hdr.msg_iov = &_iovecs[i];
+            _headers[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    UdpSource::~UdpSource()
+    {
+        ::close(_fd);
+    }
+
+    byte_buffer_view UdpSource::fill_available(size_t n, size_t min_size)
+    {
+        if (_end - _pos < n and not _at_end)
+        {
+            // Move the bytes not consumed yet to the front of the buffer, and append datagrams until the window is complete
+            // The buffer has room for one datagram past the window, so the last one doesn't need to be split
+            // The datagrams already received are all appended, but the next batch is only waited for while the window is shorter than min_size
+            std::copy(begin(_buffer) + _pos, begin(_buffer) + _end, begin(_buffer));
+            _end -= _pos;
+            _pos = 0;
+            if (_buffer.size() < n + udp_max_datagram_size)
+            {
+                _buffer.resize(n + udp_max_datagram_size);
+            }
+
+            while (_end < n)
+            {
+                if (_next_slot == _received_count)
+                {
+                    if (_end >= min_size)
+                    {
+                        break;
+                    }
+                    if (not receive())
+                    {
+                        _at_end = true;
+                        break;
+                    }
+                }
+                const mmsghdr& header{ _headers[_next_slot] };
+                const byte_buffer_view payload{ get_TS_payload({ _slots.data() + _next_slot * udp_max_datagram_size, header.msg_len }) };
+                std::copy(begin(payload), end(payload), begin(_buffer) + _end);
+                _end += payload.size();
+                _next_slot++;
+            }
+        }
+        return { _buffer.data() + _pos, std::min(n, _end - _pos) };
+    }
+
+    bool UdpSource::receive()
+    {
+        // Wait for the first datagram, and take the ones already queued along with it
+        int count{ 0 };
+        do
+        {
+            count = ::recvmmsg(_fd, _headers.data(), static_cast<unsigned>(udp_slot_count), MSG_WAITFORONE, nullptr);
+        } while (count < 0 and errno == EINTR);
+
+        if (count < 0 and (errno == EAGAIN or errno == EWOULDBLOCK))
+        {
+            return false;
+        }
+        if (count < 0)
+        {
+            throw CouldNotReadTSFile{ _url };
+        }
+        _next_slot = 0;
+        _received_count = static_cast<size_t>(count);
+        return _received_count != 0;
+    }
+
+    /* static */ byte_buffer_view UdpSource::get_TS_payload(const byte_buffer_view& datagram)
+    {
+        // TS packets straight away, or something that is not RTP, which is left to the resynchronization
+        if (datagram.size() < RTP_header_size or datagram[0] == sync_byte_valid_value or (datagram[0] >> 6) != RTP_version)
+        {
+            return datagram;
+        }
+
+        // Fixed header, CSRC identifiers, and header extension
+        size_t header_size{ RTP_header_size + 4 * (datagram[0] & 0x0f) };
+        const bool has_extension{ (datagram[0] & 0x10) != 0 };
+        if (has_extension)
+        {
+            if (datagram.size() < header_size + 4)
+            {
+                return {};
+            }
+            header_size += 4 + 4 * ((static_cast<size_t>(datagram[header_size + 2]) << 8) | datagram[header_size + 3]);
+        }
+        const bool has_padding{ (datagram[0] & 0x20) != 0 };
+        const size_t padding_size{ has_padding ? datagram.back() : size_t{ 0 } };
+        if (header_size + padding_size > datagram.size())
+        {
+            return {};
+        }
+        return datagram.subspan(header_size, datagram.size() - header_size - padding_size);
+    }
+}
+
+#endif  // TS_HAS_UDP_SOURCE
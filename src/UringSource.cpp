@@ -0,0 +1,275 @@
+#include "Exception.hpp"
+#include "UringSource.hpp"
+
+#if TS_HAS_IO_URING
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <filesystem>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace TS
+{
+    namespace
+    {
+        int io_uring_setup(unsigned entries, io_uring_params* params)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        // Ring indices are shared with the kernel
+        unsigned load_acquire(unsigned* p) { return std::atomic_ref<unsigned>{ *p }.load(std::memory_order_acquire); }
+        void store_release(unsigned* p, unsigned v) { std::atomic_ref<unsigned>{ *p }.store(v, std::memory_order_release); }
+    }
+
+    UringSource::UringSource(const std::filesystem::path& file_path)
+        : _file_path{ file_path }
+    {
+        _fd = open(file_path.c_str(), O_RDONLY);
+        struct stat file_stat{};
+        if (_fd == -1 or fstat(_fd, &file_stat) == -1)
+        {
+            if (_fd != -1) { close(_fd); }
+            throw CouldNotOpenTSFile(file_path);
+        }
+        _file_size = static_cast<size_t>(file_stat.st_size);
+        posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        try
+        {
+            setup_ring();
+        }
+        catch (...)
+        {
+            close_ring();
+            close(_fd);
+            throw;
+        }
+
+        for (Block& block : _blocks)
+        {
+            block.buffer.resize(uring_max_window_size + uring_block_size);
+        }
+
+        // The last block starts as the current one, empty, while all the others are being read
+        _current = uring_block_count - 1;
+        _begin = _end = _blocks[_current].data();
+        for (size_t i{ 0 }; i < _current; ++i)
+        {
+            submit_read(i);
+        }
+    }
+
+    UringSource::~UringSource()
+    {
+        // The kernel may still be writing into the buffers of the reads in flight
+        for (size_t i{ 0 }; i < uring_block_count; ++i)
+        {
+            try { wait_for(i); } catch (...) {}
+        }
+        close_ring();
+        close(_fd);
+    }
+
+    void UringSource::setup_ring()
+    {
+        io_uring_params params{};
+        _ring_fd = io_uring_setup(uring_block_count, &params);
+        if (_ring_fd < 0)
+        {
+            throw IoUringUnavailable{};
+        }
+
+        _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        const bool single_mmap{ (params.features & IORING_FEAT_SINGLE_MMAP) != 0 };
+        if (single_mmap)
+        {
+            _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+        }
+
+        _sq_ring = mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQ_RING);
+        if (_sq_ring == MAP_FAILED)
+        {
+            _sq_ring = nullptr;
+            throw IoUringUnavailable{};
+        }
+        if (single_mmap)
+        {
+            _cq_ring = _sq_ring;
+        }
+        else
+        {
+            _cq_ring = mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_CQ_RING);
+            if (_cq_ring == MAP_FAILED)
+            {
+                _cq_ring = nullptr;
+                throw IoUringUnavailable{};
+            }
+        }
+        _sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQES);
+        if (_sqes == MAP_FAILED)
+        {
+            _sqes = nullptr;
+            throw IoUringUnavailable{};
+        }
+
+        auto* sq{ static_cast<uint8_t*>(_sq_ring) };
+        _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        _sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        auto* cq{ static_cast<uint8_t*>(_cq_ring) };
+        _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        _cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        _cqes = cq + params.cq_off.cqes;
+    }
+
+    void UringSource::close_ring()
+    {
+        if (_sqes) { munmap(_sqes, _sqes_size); }
+        if (_cq_ring and _cq_ring != _sq_ring) { munmap(_cq_ring, _cq_ring_size); }
+        if (_sq_ring) { munmap(_sq_ring, _sq_ring_size); }
+        if (_ring_fd >= 0) { close(_ring_fd); }
+    }
+
+    void UringSource::submit_read(size_t block_index)
+    {
+        Block& block{ _blocks[block_index] };
+        if (not block.in_flight)
+        {
+            // New read: no more blocks once the end of the file is reached
+            if (_next_read_offset >= _file_size)
+            {
+                return;
+            }
+            block.offset = _next_read_offset;
+            block.size = 0;
+            block.in_flight = true;
+            _next_read_offset += uring_block_size;
+        }
+
+        // Read what is left of the block (short reads are resubmitted)
+        const size_t block_end{ std::min(block.offset + uring_block_size, _file_size) };
+        block.io.iov_base = block.data() + block.size;
+        block.io.iov_len = block_end - block.offset - block.size;
+
+        const unsigned tail{ *_sq_tail };
+        const unsigned index{ tail & *_sq_mask };
+        io_uring_sqe& sqe{ static_cast<io_uring_sqe*>(_sqes)[index] };
+        sqe = io_uring_sqe{};
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = _fd;
+        sqe.addr = reinterpret_cast<uint64_t>(&block.io);
+        sqe.len = 1;
+        sqe.off = block.offset + block.size;
+        sqe.user_data = block_index;
+        _sq_array[index] = index;
+        store_release(_sq_tail, tail + 1);
+
+        if (io_uring_enter(_ring_fd, 1, 0, 0) < 0)
+        {
+            block.in_flight = false;
+            throw CouldNotReadTSFile(_file_path);
+        }
+    }
+
+    void UringSource::wait_for(size_t block_index)
+    {
+        while (_blocks[block_index].in_flight)
+        {
+            unsigned head{ *_cq_head };
+            if (head == load_acquire(_cq_tail))
+            {
+                if (io_uring_enter(_ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 and errno != EINTR)
+                {
+                    throw CouldNotReadTSFile(_file_path);
+                }
+                continue;
+            }
+
+            // Reap completions, whichever block they belong to
+            for (; head != load_acquire(_cq_tail); ++head)
+            {
+                const io_uring_cqe& cqe{ static_cast<io_uring_cqe*>(_cqes)[head & *_cq_mask] };
+                const size_t completed_index{ static_cast<size_t>(cqe.user_data) };
+                const int result{ cqe.res };
+                store_release(_cq_head, head + 1);
+
+                Block& block{ _blocks[completed_index] };
+                if (result == -EINTR or result == -EAGAIN)
+                {
+                    submit_read(completed_index);
+                }
+                else if (result < 0)
+                {
+                    block.in_flight = false;
+                    throw CouldNotReadTSFile(_file_path);
+                }
+                else if (result == 0)
+                {
+                    // The file got shorter while being read
+                    block.in_flight = false;
+                    _file_size = std::min(_file_size, block.offset + block.size);
+                }
+                else
+                {
+                    block.size += static_cast<size_t>(result);
+                    if (block.offset + block.size < std::min(block.offset + uring_block_size, _file_size))
+                    {
+                        submit_read(completed_index);
+                    }
+                    else
+                    {
+                        block.in_flight = false;
+                    }
+                }
+            }
+        }
+    }
+
+    void UringSource::next_block()
+    {
+        const size_t next{ (_current + 1) % uring_block_count };
+        wait_for(next);
+
+        // Carry the bytes left in the current block over to the headroom of the next one
+        Block& block{ _blocks[next] };
+        uint8_t* begin{ block.data() - (_end - _begin) };
+        std::copy(_begin, _end, begin);
+        _begin = begin;
+        _end = block.data() + block.size;
+        _end_offset = block.offset + block.size;
+
+        // The current block is free now: read a new block into it
+        submit_read(_current);
+        _current = next;
+    }
+
+    byte_buffer_view UringSource::fill(size_t n)
+    {
+        if (n > uring_max_window_size)
+        {
+            throw std::invalid_argument{ "io_uring source window is too big" };
+        }
+        while (static_cast<size_t>(_end - _begin) < n and _end_offset < _file_size)
+        {
+            next_block();
+        }
+        return { _begin, std::min(n, static_cast<size_t>(_end - _begin)) };
+    }
+}
+#endif
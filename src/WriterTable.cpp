@@ -0,0 +1,60 @@
+#include "StreamType.hpp"
+#include "WriterTable.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace TS
+{
+    std::filesystem::path get_output_file_path(stream_type st, program_number n, PID p, const std::string& file_name_prefix)
+    {
+        const char* file_stem{ "ts_stream_" };
+
+        std::ostringstream oss{};
+        oss << file_name_prefix << file_stem << "0x" << std::hex << static_cast<uint16_t>(st)
+            << "_program_" << std::dec << n
+            << "_PID_0x" << std::hex << p
+            << '.' << StreamTypeMap::get_instance().get_file_extension(st);
+
+        return oss.str();
+    }
+
+    WriterTable::WriterTable(const std::vector<uint8_t>& stream_type_list, const FileWriterOptions& options)
+        : _options{ options }
+    {
+        std::for_each(cbegin(stream_type_list), cend(stream_type_list), [this](uint8_t st) { _stream_types.set(st); });
+    }
+
+    bool WriterTable::update(const PSI_Tables& PSI_tables)
+    {
+        const TPES_stream_type_cache_map& PES_stream_types{ PSI_tables.get_PES_stream_types() };
+        if (PES_stream_types.size() == _known_PES_PID_count)
+        {
+            return false;
+        }
+
+        const size_t writer_count{ _writers.size() };
+        const std::vector<PID>& PES_PIDs{ PES_stream_types.get_PIDs() };
+        for (auto it = cbegin(PES_PIDs) + _known_PES_PID_count; it != cend(PES_PIDs); ++it)
+        {
+            const PID p{ *it };
+            const stream_type st{ PES_stream_types.at(p) };
+            if (not _stream_types[st])
+            {
+                continue;
+            }
+            const std::filesystem::path file_path{ get_output_file_path(st, PSI_tables.get_PES_program_number(p), p, _options.file_name_prefix) };
+            _writers.push_back(std::make_unique<FileWriter>(st, file_path, _options));
+            _writers_by_PID[p] = _writers.back().get();
+            _PIDs.push_back(p);
+        }
+        _known_PES_PID_count = PES_stream_types.size();
+        return _writers.size() != writer_count;
+    }
+
+    void WriterTable::close()
+    {
+        std::for_each(begin(_writers), end(_writers), [](std::unique_ptr<FileWriter>& fw_uptr) { fw_uptr->close(); });
+    }
+}
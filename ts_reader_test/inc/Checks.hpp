@@ -0,0 +1,15 @@
+#ifndef __TS_READER_TEST_CHECKS_HPP__
+#define __TS_READER_TEST_CHECKS_HPP__
+
+#include <filesystem>
+
+// Checks of the TS reader, run by ts_reader_test
+// Each check prints what it checked, and an error message for every failure, and returns false if any
+//
+bool check_allocations(const std::filesystem::path& ts_file_path);
+bool check_CRC32();
+bool check_header_kernels();
+bool check_lost_PSI_packet(const std::filesystem::path& ts_file_path);
+bool check_UDP_source(const std::filesystem::path& ts_file_path);
+
+#endif
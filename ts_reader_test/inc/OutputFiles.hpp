@@ -0,0 +1,18 @@
+#ifndef __TS_READER_TEST_OUTPUT_FILES_HPP__
+#define __TS_READER_TEST_OUTPUT_FILES_HPP__
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Helpers of the checks that demux to output files, written to the current directory with a prefix of their own
+//
+std::vector<uint8_t> read_file(const std::filesystem::path& file_path);
+void write_file(const std::filesystem::path& file_path, const std::vector<uint8_t>& bytes);
+
+// Output files written with the given prefix, without it
+std::vector<std::string> get_output_file_names(const std::string& file_name_prefix);
+void remove_output_files(const std::string& file_name_prefix);
+
+#endif
@@ -0,0 +1,122 @@
+#include "Checks.hpp"
+
+#include "DemuxContext.hpp"
+#include "PacketBuffer.hpp"
+#include "PacketLayout.hpp"
+#include "PacketParser.hpp"
+#include "PacketProcessor.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <vector>
+
+// Heap allocations are counted while counting_allocations is set
+size_t allocation_count{ 0 };
+bool counting_allocations{ false };
+
+void* operator new(size_t size)
+{
+    if (counting_allocations) { allocation_count++; }
+    if (void* p = std::malloc(size ? size : 1)) { return p; }
+    throw std::bad_alloc{};
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace
+{
+    // Stores 188-byte TS packets as the given layout does (with zeroed prefixes and suffixes)
+    template <typename Layout>
+    std::vector<uint8_t> to_layout(const std::vector<uint8_t>& ts)
+    {
+        std::vector<uint8_t> ret{};
+        ret.reserve(ts.size() / TS::packet_size * Layout::stride);
+        for (size_t pos{ 0 }; pos + TS::packet_size <= ts.size(); pos += TS::packet_size)
+        {
+            ret.insert(ret.end(), Layout::prefix_size, 0);
+            ret.insert(ret.end(), ts.begin() + pos, ts.begin() + pos + TS::packet_size);
+            ret.insert(ret.end(), Layout::suffix_size, 0);
+        }
+        return ret;
+    }
+
+    // Parses the packets twice: the first pass builds the PSI tables and grows the section buffers,
+    // and the second one, where every PSI section repeats, counts the heap allocations
+    template <typename Layout>
+    bool check_allocations(const std::vector<uint8_t>& ts)
+    {
+        std::vector<uint8_t> v{ to_layout<Layout>(ts) };
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        std::ostringstream oss{};
+        TS::DemuxContext context{ oss };
+        TS::BasicPacketParser<Layout> parser{ context };
+        TS::PacketProcessor processor{ context };
+
+        allocation_count = 0;
+        size_t num_packets{ 0 };
+        for (bool counting : { false, true })
+        {
+            for (size_t pos{ 0 };
+                pos + Layout::stride <= v.size() and v[pos + Layout::prefix_size] == TS::sync_byte_valid_value;
+                pos += Layout::stride)
+            {
+                TS::BasicPacketBuffer<Layout> buffer{ TS::byte_buffer_view{ v.data() + pos, Layout::stride } };
+
+                counting_allocations = counting;
+                auto result = parser.parse(buffer);
+                counting_allocations = false;
+                num_packets += counting;
+
+                // PSI tables are processed, so that PMT packets are told apart
+                if (result and parser.get_packet().payload_contains_PSI())
+                {
+                    [[maybe_unused]] auto processed = processor.process(parser.get_packet());
+                }
+            }
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        using fms = std::chrono::duration<long double, std::chrono::milliseconds::period>;
+        auto interval = fms(end - start);
+
+        std::cout << "Parsing " << num_packets << " packets of " << static_cast<int>(Layout::stride) << " bytes"
+            << " with " << allocation_count << " heap allocations"
+            << " after a first pass: "
+            << std::fixed << fms(interval).count() << " ms\n";
+        if (num_packets == 0)
+        {
+            std::cerr << "Error: no packets were parsed\n";
+            return false;
+        }
+        if (allocation_count != 0)
+        {
+            std::cerr << "Error: parsing packets allocated memory\n";
+            return false;
+        }
+        return true;
+    }
+}
+
+// Once the parser has seen the PSI sections of a TS file, parsing them again should not allocate anymore, whatever the packet layout
+bool check_allocations(const std::filesystem::path& ts_file_path)
+{
+    std::ifstream ifs{ ts_file_path, std::fstream::binary };
+    size_t file_size = static_cast<size_t>(std::filesystem::file_size(ts_file_path));
+
+    std::vector<uint8_t> ts(file_size);  // bytes
+    ifs.read(reinterpret_cast<char*>(ts.data()), file_size);
+
+    const bool ok_188{ check_allocations<TS::TS_188_layout>(ts) };
+    const bool ok_192{ check_allocations<TS::M2TS_192_layout>(ts) };
+    const bool ok_204{ check_allocations<TS::TS_204_layout>(ts) };
+    return ok_188 and ok_192 and ok_204;
+}
@@ -0,0 +1,61 @@
+#include "Checks.hpp"
+
+#include "CRC32.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// Every CRC32 engine must match the byte-by-byte boost reference,
+// whatever the length of the data (both below and above the 64-byte PCLMUL blocks), and its alignment
+bool check_CRC32()
+{
+    constexpr size_t max_size{ 4096 };
+    constexpr std::array<size_t, 6> alignments{ 0, 1, 3, 7, 8, 15 };
+
+    // Pseudo-random data, with some room for the alignment offsets
+    std::vector<uint8_t> v(max_size + 16);
+    uint32_t seed{ 0x1234'5678 };
+    for (auto& b : v)
+    {
+        seed = seed * 1'664'525 + 1'013'904'223;
+        b = static_cast<uint8_t>(seed >> 24);
+    }
+
+    size_t num_checks{ 0 };
+    size_t num_errors{ 0 };
+    for (size_t alignment : alignments)
+    {
+        const uint8_t* data{ v.data() + alignment };
+        for (size_t size{ 0 }; size <= max_size; ++size)
+        {
+            const uint32_t expected{ TS::crc32_mpeg2_reference(data, size) };
+            const uint32_t slicing_by_8{ TS::crc32_mpeg2_slicing_by_8(data, size) };
+            const uint32_t PCLMUL{ TS::crc32_mpeg2_PCLMUL(data, size) };
+            const uint32_t dispatched{ TS::crc32_mpeg2(data, size) };
+            // Computing the CRC in two steps gives the same result
+            const uint32_t chained{ TS::crc32_mpeg2(data + size / 2, size - size / 2, TS::crc32_mpeg2(data, size / 2)) };
+            num_checks++;
+
+            if (slicing_by_8 != expected or PCLMUL != expected or dispatched != expected or chained != expected)
+            {
+                if (num_errors++ < 10)
+                {
+                    std::cerr << "Error: CRC32 mismatch for " << size << " bytes at alignment " << alignment << ": "
+                        << std::hex << "reference=0x" << expected
+                        << ", slicing-by-8=0x" << slicing_by_8
+                        << ", PCLMUL=0x" << PCLMUL
+                        << ", crc32_mpeg2=0x" << dispatched
+                        << ", chained=0x" << chained << std::dec << "\n";
+                }
+            }
+        }
+    }
+
+    std::cout << "Checking CRC32 engines against the reference for " << num_checks << " buffers"
+        << " (0 to " << max_size << " bytes, " << alignments.size() << " alignments): "
+        << num_errors << " errors\n";
+    return num_errors == 0;
+}
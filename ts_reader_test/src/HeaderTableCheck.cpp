@@ -0,0 +1,111 @@
+#include "Checks.hpp"
+
+#include "HeaderTable.hpp"
+#include "PacketLayout.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using kernel_type = std::function<void(const TS::byte_buffer_view&, TS::HeaderTable&, size_t, size_t)>;
+
+    // Whether the first n entries of two field arrays are equal
+    template <typename T>
+    bool equal_fields(const std::vector<T>& lhs, const std::vector<T>& rhs, size_t n)
+    {
+        return std::equal(lhs.begin(), lhs.begin() + n, rhs.begin());
+    }
+
+    bool equal_tables(const TS::HeaderTable& lhs, const TS::HeaderTable& rhs)
+    {
+        const size_t n{ lhs.size() };
+        return lhs.size() == rhs.size()
+            and equal_fields(lhs.sync_byte, rhs.sync_byte, n)
+            and equal_fields(lhs.transport_error_indicator, rhs.transport_error_indicator, n)
+            and equal_fields(lhs.payload_unit_start_indicator, rhs.payload_unit_start_indicator, n)
+            and equal_fields(lhs.PID, rhs.PID, n)
+            and equal_fields(lhs.transport_scrambling_control, rhs.transport_scrambling_control, n)
+            and equal_fields(lhs.adaptation_field_control, rhs.adaptation_field_control, n)
+            and equal_fields(lhs.continuity_counter, rhs.continuity_counter, n);
+    }
+
+    // Decodes random headers stored as the given layout does, for every packet count up to max_packet_count,
+    // and compares the tables of the SIMD kernels with the one of the scalar kernel
+    template <typename Layout>
+    size_t check_header_kernels(size_t max_packet_count, size_t& num_checks)
+    {
+        const std::vector<std::pair<kernel_type, const char*>> kernels{
+            { TS::decode_headers_SSE4_1, "SSE4.1" },
+            { TS::decode_headers_AVX2, "AVX2" },
+            { [](const auto& packets, auto& table, size_t stride, size_t prefix_size) {
+                TS::decode_headers(packets, table, stride, prefix_size); }, "decode_headers" },
+        };
+
+        // Pseudo-random bytes, headers included, plus a partial packet that must not be decoded
+        std::vector<uint8_t> v((max_packet_count + 1) * Layout::stride - 1);
+        uint32_t seed{ 0x8765'4321 };
+        for (auto& b : v)
+        {
+            seed = seed * 1'664'525 + 1'013'904'223;
+            b = static_cast<uint8_t>(seed >> 24);
+        }
+
+        size_t num_errors{ 0 };
+        for (size_t count{ 0 }; count <= max_packet_count; ++count)
+        {
+            const TS::byte_buffer_view packets{ v.data(), count * Layout::stride + Layout::stride - 1 };
+
+            TS::HeaderTable expected{};
+            TS::decode_headers_scalar(packets, expected, Layout::stride, Layout::prefix_size);
+            if (expected.size() != count)
+            {
+                if (num_errors++ < 10)
+                {
+                    std::cerr << "Error: the scalar kernel decoded " << expected.size() << " headers instead of " << count
+                        << " for " << static_cast<int>(Layout::stride) << "-byte packets\n";
+                }
+            }
+
+            for (const auto& [kernel, name] : kernels)
+            {
+                TS::HeaderTable table{};
+                kernel(packets, table, Layout::stride, Layout::prefix_size);
+                num_checks++;
+
+                if (not equal_tables(table, expected))
+                {
+                    if (num_errors++ < 10)
+                    {
+                        std::cerr << "Error: the " << name << " kernel decoded different headers than the scalar one for "
+                            << count << " packets of " << static_cast<int>(Layout::stride) << " bytes\n";
+                    }
+                }
+            }
+        }
+        return num_errors;
+    }
+}
+
+// Every header decoding kernel must decode the same table as the scalar one, whatever the packet layout,
+// and for every packet count, so that the packets left over by the vector loops are checked too
+bool check_header_kernels()
+{
+    constexpr size_t max_packet_count{ 40 };
+
+    size_t num_checks{ 0 };
+    size_t num_errors{ 0 };
+    num_errors += check_header_kernels<TS::TS_188_layout>(max_packet_count, num_checks);
+    num_errors += check_header_kernels<TS::M2TS_192_layout>(max_packet_count, num_checks);
+    num_errors += check_header_kernels<TS::TS_204_layout>(max_packet_count, num_checks);
+
+    std::cout << "Checking header kernels against the scalar one for " << num_checks << " blocks"
+        << " (0 to " << max_packet_count << " packets of 188, 192 and 204 bytes): "
+        << num_errors << " errors\n";
+    return num_errors == 0;
+}
@@ -0,0 +1,107 @@
+#include "Checks.hpp"
+
+#include "DemuxContext.hpp"
+#include "FileReader.hpp"
+#include "OutputFiles.hpp"
+#include "Packet.hpp"
+#include "ParseResult.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Demuxes a TS file, extracting AAC and H.264 streams, into output files with the given prefix
+    // Packets that can't be demuxed are skipped
+    void demux(TS::DemuxContext& context, const std::filesystem::path& ts_file_path, const std::string& file_name_prefix)
+    {
+        TS::FileReaderOptions options{};
+        options.stream_type_list = { 0x0f, 0x1b };
+        options.error_policy = TS::ErrorPolicy::skip;
+        options.writer_options.file_name_prefix = file_name_prefix;
+
+        TS::FileReader ts_reader{ context, ts_file_path, options };
+        ts_reader.start();
+    }
+
+    // Index of the first 188-byte packet continuing a PMT section started in a previous packet, if any
+    std::optional<size_t> find_PMT_continuation_packet(const std::vector<uint8_t>& ts, const TS::PSI_Tables& PSI_tables)
+    {
+        for (size_t pos{ 0 }; pos + TS::packet_size <= ts.size() and ts[pos] == TS::sync_byte_valid_value; pos += TS::packet_size)
+        {
+            const bool payload_unit_start_indicator{ (ts[pos + 1] & 0x40) != 0 };
+            const uint16_t pid{ static_cast<uint16_t>(((ts[pos + 1] & 0x1f) << 8) | ts[pos + 2]) };
+            if (not payload_unit_start_indicator and PSI_tables.is_PMT_PID(pid))
+            {
+                return pos / TS::packet_size;
+            }
+        }
+        return std::nullopt;
+    }
+}
+
+// Losing a packet of a PMT section spanning across packets must only drop that section:
+// the next repetition of the PMT has to be demuxed, so that every program is still extracted, and the drop counted as an error
+bool check_lost_PSI_packet(const std::filesystem::path& ts_file_path)
+{
+    const std::vector<uint8_t> ts{ read_file(ts_file_path) };
+    const std::string file_prefix{ "lost_packet_check_file_" };
+    const std::string lost_prefix{ "lost_packet_check_lost_" };
+    const std::filesystem::path lost_file_path{ "lost_packet_check.ts" };
+
+    size_t num_errors{ 0 };
+    std::optional<size_t> lost_packet_index{};
+    try
+    {
+        std::ostringstream file_oss{};
+        TS::DemuxContext file_context{ file_oss };
+        demux(file_context, ts_file_path, file_prefix);
+
+        lost_packet_index = find_PMT_continuation_packet(ts, file_context.PSI_tables);
+        if (lost_packet_index)
+        {
+            std::vector<uint8_t> lost_ts{ ts };
+            const auto lost_packet_it{ lost_ts.begin() + *lost_packet_index * TS::packet_size };
+            lost_ts.erase(lost_packet_it, lost_packet_it + TS::packet_size);
+            write_file(lost_file_path, lost_ts);
+
+            std::ostringstream lost_oss{};
+            TS::DemuxContext lost_context{ lost_oss };
+            demux(lost_context, lost_file_path, lost_prefix);
+
+            if (get_output_file_names(lost_prefix) != get_output_file_names(file_prefix))
+            {
+                std::cerr << "Error: the TS file with a lost PMT packet demuxed to different elementary streams than the TS file\n";
+                num_errors++;
+            }
+            if (lost_context.parse_errors.get_count(TS::ParseError::Dropped_section) == 0)
+            {
+                std::cerr << "Error: the PMT section of the lost packet was not reported as dropped\n";
+                num_errors++;
+            }
+        }
+    }
+    catch (const std::exception& err)
+    {
+        std::cerr << "Error: " << err.what() << "\n";
+        num_errors++;
+    }
+    remove_output_files(file_prefix);
+    remove_output_files(lost_prefix);
+    std::filesystem::remove(lost_file_path);
+
+    if (not lost_packet_index)
+    {
+        std::cout << "Checking a lost PMT packet: no PMT section spanning across packets in the TS file\n";
+        return num_errors == 0;
+    }
+    std::cout << "Checking a lost PMT packet (packet " << *lost_packet_index << "): " << num_errors << " errors\n";
+    return num_errors == 0;
+}
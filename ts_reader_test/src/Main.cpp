@@ -1,22 +1,33 @@
+#include "Checks.hpp"
+
 #include <boost/dynamic_bitset/dynamic_bitset.hpp>
 #include <chrono>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <vector>
 
+// TS file checked when none is given
+#ifndef TS_READER_TEST_SAMPLES_DIR
+#define TS_READER_TEST_SAMPLES_DIR "../samples"
+#endif
+const std::filesystem::path default_ts_file_path{ std::filesystem::path{ TS_READER_TEST_SAMPLES_DIR } / "multiPacketPSI.ts" };
+
 int main(int argc, char* argv[])
 {
-    if (argc != 2)
+    if (argc > 2)
     {
-        std::cerr << "Usage: ts_reader_test <TS FILE PATH>\n";
+        std::cerr << "Usage: ts_reader_test [<TS FILE PATH>]\n";
         std::cerr << "\n";
         std::cerr << "  E.g: ts_reader_test elephants.ts\n";
+        std::cerr << "  Without a TS file path, " << default_ts_file_path.filename().string() << " from the samples is checked\n";
         exit(EXIT_FAILURE);
     }
-    if (!std::filesystem::exists(argv[1]))
+    const std::filesystem::path ts_file_path{ argc == 2 ? std::filesystem::path{ argv[1] } : default_ts_file_path };
+    if (!std::filesystem::exists(ts_file_path))
     {
-        std::cerr << "Error: couldn't find TS file path: '" << argv[1] << "'\n";
+        std::cerr << "Error: couldn't find TS file path: '" << ts_file_path.string() << "'\n";
         exit(EXIT_FAILURE);
     }
 
@@ -50,7 +61,6 @@ int main(int argc, char* argv[])
     {
         auto start = std::chrono::high_resolution_clock::now();
 
-        std::filesystem::path ts_file_path{ argv[1] };
         std::ifstream ifs{ ts_file_path, std::fstream::binary };
         size_t file_size = static_cast<size_t>(std::filesystem::file_size(ts_file_path));
         size_t num_blocks = file_size / sizeof(boost::dynamic_bitset<>::block_type);
@@ -75,7 +85,6 @@ int main(int argc, char* argv[])
     {
         auto start = std::chrono::high_resolution_clock::now();
 
-        std::filesystem::path ts_file_path{ argv[1] };
         std::ifstream ifs{ ts_file_path, std::fstream::binary };
         size_t file_size = static_cast<size_t>(std::filesystem::file_size(ts_file_path));
         size_t num_blocks = file_size;
@@ -100,7 +109,6 @@ int main(int argc, char* argv[])
     {
         auto start = std::chrono::high_resolution_clock::now();
 
-        std::filesystem::path ts_file_path{ argv[1] };
         std::ifstream ifs{ ts_file_path, std::fstream::binary };
         size_t file_size = static_cast<size_t>(std::filesystem::file_size(ts_file_path));
         size_t file_chunk_size = 1024 * 1024; // 1 MB
@@ -128,4 +136,34 @@ int main(int argc, char* argv[])
             << " of " << sizeof(boost::dynamic_bitset<uint8_t>::block_type) << " bytes: "
             << std::fixed << fms(interval).count() << " ms\n";
     }
+
+    // Parse TS file (packet by packet), counting heap allocations
+    if (not check_allocations(ts_file_path))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    // Check CRC32 engines
+    if (not check_CRC32())
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    // Check header decoding kernels
+    if (not check_header_kernels())
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    // Check lost PSI packets
+    if (not check_lost_PSI_packet(ts_file_path))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    // Check UDP source
+    if (not check_UDP_source(ts_file_path))
+    {
+        exit(EXIT_FAILURE);
+    }
 }
@@ -0,0 +1,40 @@
+#include "OutputFiles.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+std::vector<uint8_t> read_file(const std::filesystem::path& file_path)
+{
+    std::ifstream ifs{ file_path, std::fstream::binary };
+    return { std::istreambuf_iterator<char>{ ifs }, std::istreambuf_iterator<char>{} };
+}
+
+void write_file(const std::filesystem::path& file_path, const std::vector<uint8_t>& bytes)
+{
+    std::ofstream ofs{ file_path, std::fstream::binary };
+    ofs.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+std::vector<std::string> get_output_file_names(const std::string& file_name_prefix)
+{
+    std::vector<std::string> ret{};
+    for (const auto& entry : std::filesystem::directory_iterator{ std::filesystem::current_path() })
+    {
+        const std::string file_name{ entry.path().filename().string() };
+        if (file_name.starts_with(file_name_prefix))
+        {
+            ret.push_back(file_name.substr(file_name_prefix.size()));
+        }
+    }
+    std::sort(begin(ret), end(ret));
+    return ret;
+}
+
+void remove_output_files(const std::string& file_name_prefix)
+{
+    for (const std::string& file_name : get_output_file_names(file_name_prefix))
+    {
+        std::filesystem::remove(file_name_prefix + file_name);
+    }
+}
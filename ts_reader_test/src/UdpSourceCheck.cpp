@@ -0,0 +1,210 @@
+#include "Checks.hpp"
+
+#include "UdpSource.hpp"
+
+#include <iostream>
+
+#if TS_HAS_UDP_SOURCE
+
+#include "DemuxContext.hpp"
+#include "FileReader.hpp"
+#include "OutputFiles.hpp"
+#include "Packet.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    // Datagrams carry 7 TS packets, as IPTV streams usually do
+    constexpr size_t datagram_payload_size{ 7 * TS::packet_size };
+    // The reader ends the UDP input after this long without datagrams
+    constexpr uint64_t idle_timeout_ms{ 500 };
+
+    enum class Encapsulation { raw, RTP };
+
+    // Asks the kernel for a free loopback port
+    uint16_t get_free_port()
+    {
+        const int fd{ ::socket(AF_INET, SOCK_DGRAM, 0) };
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t address_size{ sizeof(address) };
+        ::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &address_size);
+        ::close(fd);
+        return ntohs(address.sin_port);
+    }
+
+    // RTP header (RFC 3550) with 2 CSRC identifiers and a 1-word header extension, before the TS packets,
+    // and 4 padding bytes after them
+    std::vector<uint8_t> wrap_in_RTP(const uint8_t* payload, size_t payload_size, uint16_t sequence_number)
+    {
+        std::vector<uint8_t> ret{
+            0x80 | 0x20 | 0x10 | 0x02,  // version 2, padding, extension, 2 CSRCs
+            33,  // payload type: MP2T
+            static_cast<uint8_t>(sequence_number >> 8), static_cast<uint8_t>(sequence_number),
+            0x00, 0x01, 0x5f, 0x90,  // timestamp
+            0x12, 0x34, 0x56, 0x78,  // SSRC
+            0x00, 0x00, 0x00, 0x01,  // CSRC 1
+            0x00, 0x00, 0x00, 0x02,  // CSRC 2
+            0xbe, 0xde, 0x00, 0x01,  // extension profile and length (in 32-bit words)
+            0xaa, 0xbb, 0xcc, 0xdd,  // extension
+        };
+        ret.insert(ret.end(), payload, payload + payload_size);
+        ret.insert(ret.end(), { 0x00, 0x00, 0x00, 0x04 });  // padding, its last byte being its size
+        return ret;
+    }
+
+    // Sends the TS to the loopback port, 7 packets per datagram
+    void send_TS(const std::vector<uint8_t>& ts, uint16_t port, Encapsulation encapsulation)
+    {
+        const int fd{ ::socket(AF_INET, SOCK_DGRAM, 0) };
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+
+        uint16_t sequence_number{ 0 };
+        for (size_t pos{ 0 }; pos < ts.size(); pos += datagram_payload_size)
+        {
+            const size_t payload_size{ std::min(datagram_payload_size, ts.size() - pos) };
+            const std::vector<uint8_t> datagram{ encapsulation == Encapsulation::RTP
+                ? wrap_in_RTP(ts.data() + pos, payload_size, sequence_number++)
+                : std::vector<uint8_t>(ts.data() + pos, ts.data() + pos + payload_size) };
+            ::sendto(fd, datagram.data(), datagram.size(), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+
+            // Don't outrun the receive buffer of the reader
+            if (sequence_number % 16 == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+            }
+        }
+        ::close(fd);
+    }
+
+    // Demuxes an input, extracting AAC and H.264 streams, into output files with the given prefix,
+    // and returns the messages of the reader (stats, and bytes skipped while resynchronizing)
+    // If port is set, the input is the UDP socket, and the TS is sent to it meanwhile
+    std::string demux(const std::filesystem::path& input, const std::string& file_name_prefix,
+        const std::vector<uint8_t>& ts = {}, uint16_t port = 0, Encapsulation encapsulation = Encapsulation::raw)
+    {
+        std::ostringstream oss{};
+        TS::DemuxContext context{ oss };
+        TS::FileReaderOptions options{};
+        options.stream_type_list = { 0x0f, 0x1b };
+        options.collect_stats = true;
+        options.idle_timeout_ms = idle_timeout_ms;
+        options.error_policy = TS::ErrorPolicy::skip;
+        options.writer_options.file_name_prefix = file_name_prefix;
+
+        // The socket is bound by the reader, so the TS is sent once the reader is created
+        TS::FileReader ts_reader{ context, input, options };
+        std::thread sender{};
+        if (port != 0)
+        {
+            sender = std::thread{ send_TS, std::cref(ts), port, encapsulation };
+        }
+        std::exception_ptr error{};
+        try
+        {
+            ts_reader.start();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        if (sender.joinable())
+        {
+            sender.join();
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        return oss.str();
+    }
+}
+
+// Sending a TS over loopback UDP, as raw datagrams and wrapped in RTP, must demux to the same elementary streams as the TS file
+bool check_UDP_source(const std::filesystem::path& ts_file_path)
+{
+    const std::vector<uint8_t> ts{ read_file(ts_file_path) };
+    const std::string file_prefix{ "udp_check_file_" };
+
+    size_t num_errors{ 0 };
+    try
+    {
+        const std::string file_messages{ demux(ts_file_path, file_prefix) };
+        const std::vector<std::string> file_outputs{ get_output_file_names(file_prefix) };
+        if (file_outputs.empty())
+        {
+            std::cerr << "Error: no elementary streams demuxed from the TS file\n";
+            num_errors++;
+        }
+
+        for (auto [encapsulation, name] : { std::pair{ Encapsulation::raw, "raw" }, std::pair{ Encapsulation::RTP, "RTP" } })
+        {
+            const std::string udp_prefix{ std::string{ "udp_check_" } + name + "_" };
+            const uint16_t port{ get_free_port() };
+            const std::string udp_messages{ demux("udp://127.0.0.1:" + std::to_string(port), udp_prefix, ts, port, encapsulation) };
+
+            if (udp_messages != file_messages)
+            {
+                std::cerr << "Error: " << name << " UDP datagrams demuxed with different stats or messages than the TS file:\n"
+                    << udp_messages;
+                num_errors++;
+            }
+
+            if (get_output_file_names(udp_prefix) != file_outputs)
+            {
+                std::cerr << "Error: " << name << " UDP datagrams demuxed to different elementary streams than the TS file\n";
+                num_errors++;
+            }
+            for (const std::string& file_name : file_outputs)
+            {
+                if (read_file(udp_prefix + file_name) != read_file(file_prefix + file_name))
+                {
+                    std::cerr << "Error: " << name << " UDP datagrams demuxed to a different " << file_name << "\n";
+                    num_errors++;
+                }
+            }
+            remove_output_files(udp_prefix);
+        }
+    }
+    catch (const std::exception& err)
+    {
+        std::cerr << "Error: " << err.what() << "\n";
+        num_errors++;
+    }
+    remove_output_files(file_prefix);
+
+    std::cout << "Checking UDP source against the TS file for raw and RTP datagrams: " << num_errors << " errors\n";
+    return num_errors == 0;
+}
+
+#else
+
+bool check_UDP_source(const std::filesystem::path&)
+{
+    std::cout << "Checking UDP source: not supported on this platform\n";
+    return true;
+}
+
+#endif  // TS_HAS_UDP_SOURCE